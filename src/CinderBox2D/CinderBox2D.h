@@ -39,10 +39,14 @@ For discussion please visit http://box2d.org/forum
 #include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
 
 #include <CinderBox2D/Collision/cb2BroadPhase.h>
 #include <CinderBox2D/Collision/cb2Distance.h>
 #include <CinderBox2D/Collision/cb2DynamicTree.h>
+#include <CinderBox2D/Collision/cb2SpatialHashBroadPhase.h>
+#include <CinderBox2D/Collision/cb2SweepAndPruneBroadPhase.h>
 #include <CinderBox2D/Collision/cb2TimeOfImpact.h>
 
 #include <CinderBox2D/Dynamics/cb2Body.h>
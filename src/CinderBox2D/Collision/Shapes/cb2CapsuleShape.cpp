@@ -0,0 +1,179 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <new>
+
+void cb2CapsuleShape::Set(const ci::Vec2f& v1, const ci::Vec2f& v2, float radius)
+{
+	cb2Assert(cb2DistanceSquared(v1, v2) > cb2_linearSlop * cb2_linearSlop);
+	cb2Assert(radius > 0.0f);
+	m_vertex1 = v1;
+	m_vertex2 = v2;
+	m_radius = radius;
+}
+
+cb2Shape* cb2CapsuleShape::Clone(cb2BlockAllocator* allocator) const
+{
+	void* mem = allocator->Allocate(sizeof(cb2CapsuleShape));
+	cb2CapsuleShape* clone = new (mem) cb2CapsuleShape;
+	*clone = *this;
+	return clone;
+}
+
+int cb2CapsuleShape::GetChildCount() const
+{
+	return 1;
+}
+
+bool cb2CapsuleShape::TestPoint(const cb2Transform& xf, const ci::Vec2f& p) const
+{
+	ci::Vec2f pLocal = cb2MulT(xf, p);
+	ci::Vec2f e = m_vertex2 - m_vertex1;
+	float s = cb2Clamp(cb2Dot(pLocal - m_vertex1, e) / cb2Dot(e, e), 0.0f, 1.0f);
+	ci::Vec2f closest = m_vertex1 + s * e;
+	return cb2DistanceSquared(pLocal, closest) <= m_radius * m_radius;
+}
+
+// The capsule boundary is two flat sides parallel to the segment and two
+// half circles at the end points. A ray that starts outside enters through
+// the first of these it hits.
+bool cb2CapsuleShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
+							const cb2Transform& xf, int childIndex) const
+{
+	CB2_NOT_USED(childIndex);
+
+	// Put the ray into the capsule's frame of reference.
+	ci::Vec2f p1 = cb2MulT(xf.q, input.p1 - xf.p);
+	ci::Vec2f p2 = cb2MulT(xf.q, input.p2 - xf.p);
+	ci::Vec2f d = p2 - p1;
+	float dd = cb2Dot(d, d);
+	if (dd < cb2_epsilon)
+	{
+		return false;
+	}
+
+	ci::Vec2f e = m_vertex2 - m_vertex1;
+	float length = e.length();
+	ci::Vec2f axis = e / length;
+	ci::Vec2f normal(axis.y, -axis.x);
+
+	// The ray in the segment frame, with vertex1 at the origin.
+	ci::Vec2f q = p1 - m_vertex1;
+	float qx = cb2Dot(q, axis);
+	float qy = cb2Dot(q, normal);
+	float dx = cb2Dot(d, axis);
+	float dy = cb2Dot(d, normal);
+
+	// A ray that starts inside does not hit.
+	float rr = m_radius * m_radius;
+	float cx = cb2Clamp(qx, 0.0f, length);
+	if ((qx - cx) * (qx - cx) + qy * qy < rr)
+	{
+		return false;
+	}
+
+	float fraction = input.maxFraction;
+	ci::Vec2f hitNormal;
+	bool hit = false;
+
+	// The flat side facing the ray origin.
+	float side = qy > 0.0f ? 1.0f : -1.0f;
+	if (dy * side < 0.0f)
+	{
+		float t = (side * m_radius - qy) / dy;
+		float x = qx + t * dx;
+		if (0.0f <= t && t <= fraction && 0.0f <= x && x <= length)
+		{
+			fraction = t;
+			hitNormal = side * normal;
+			hit = true;
+		}
+	}
+
+	// The rounded ends, as in cb2CircleShape::RayCast.
+	const ci::Vec2f* centers = &m_vertex1;
+	for (int i = 0; i < 2; ++i)
+	{
+		ci::Vec2f s = p1 - centers[i];
+		float b = cb2Dot(s, s) - rr;
+		float c = cb2Dot(s, d);
+		float sigma = c * c - dd * b;
+		if (sigma < 0.0f)
+		{
+			continue;
+		}
+
+		float a = -(c + cb2Sqrt(sigma));
+		if (0.0f <= a && a <= fraction * dd)
+		{
+			fraction = a / dd;
+			hitNormal = s + fraction * d;
+			hitNormal.normalize();
+			hit = true;
+		}
+	}
+
+	if (hit == false)
+	{
+		return false;
+	}
+
+	output->fraction = fraction;
+	output->normal = cb2Mul(xf.q, hitNormal);
+	return true;
+}
+
+void cb2CapsuleShape::ComputeAABB(cb2AABB* aabb, const cb2Transform& xf, int childIndex) const
+{
+	CB2_NOT_USED(childIndex);
+
+	ci::Vec2f v1 = cb2Mul(xf, m_vertex1);
+	ci::Vec2f v2 = cb2Mul(xf, m_vertex2);
+
+	ci::Vec2f lower = cb2Min(v1, v2);
+	ci::Vec2f upper = cb2Max(v1, v2);
+
+	ci::Vec2f r(m_radius, m_radius);
+	aabb->lowerBound = lower - r;
+	aabb->upperBound = upper + r;
+}
+
+// The capsule is a box of the segment length and twice the radius, plus two
+// half circles. Each half circle has its centroid 4r/(3pi) beyond its end of
+// the box, so the parallel axis theorem is applied twice to move it there.
+void cb2CapsuleShape::ComputeMass(cb2MassData* massData, float density) const
+{
+	float rr = m_radius * m_radius;
+	float length = cb2Distance(m_vertex1, m_vertex2);
+	float ll = length * length;
+
+	float circleMass = density * cb2_pi * rr;
+	float boxMass = density * 2.0f * m_radius * length;
+	massData->mass = circleMass + boxMass;
+	massData->center = 0.5f * (m_vertex1 + m_vertex2);
+
+	float lc = 4.0f * m_radius / (3.0f * cb2_pi);
+	float h = 0.5f * length;
+	float circleInertia = circleMass * (0.5f * rr + h * h + 2.0f * h * lc);
+	float boxInertia = boxMass * (4.0f * rr + ll) / 12.0f;
+
+	// inertia about the local origin
+	massData->I = circleInertia + boxInertia + massData->mass * cb2Dot(massData->center, massData->center);
+}
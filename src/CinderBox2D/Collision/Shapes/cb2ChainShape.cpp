@@ -21,11 +21,66 @@
 #include <new>
 #include <memory.h>
 
+cb2ChainShape::cb2ChainShape(const cb2ChainShape& other)
+{
+	m_vertices = NULL;
+	m_count = 0;
+	m_edgeTree = NULL;
+	Copy(other);
+}
+
 cb2ChainShape::~cb2ChainShape()
+{
+	Free();
+}
+
+cb2ChainShape& cb2ChainShape::operator=(const cb2ChainShape& other)
+{
+	if (this != &other)
+	{
+		Free();
+		Copy(other);
+	}
+
+	return *this;
+}
+
+void cb2ChainShape::Copy(const cb2ChainShape& other)
+{
+	m_type = other.m_type;
+	m_radius = other.m_radius;
+
+	if (other.m_vertices != NULL)
+	{
+		m_vertices = (ci::Vec2f*)cb2Alloc(other.m_count * sizeof(ci::Vec2f));
+		memcpy(m_vertices, other.m_vertices, other.m_count * sizeof(ci::Vec2f));
+	}
+	m_count = other.m_count;
+
+	m_prevVertex = other.m_prevVertex;
+	m_nextVertex = other.m_nextVertex;
+	m_hasPrevVertex = other.m_hasPrevVertex;
+	m_hasNextVertex = other.m_hasNextVertex;
+	m_midPhase = other.m_midPhase;
+
+	if (other.m_edgeTree != NULL)
+	{
+		BuildEdgeTree();
+	}
+}
+
+void cb2ChainShape::Free()
 {
 	cb2Free(m_vertices);
 	m_vertices = NULL;
 	m_count = 0;
+
+	if (m_edgeTree != NULL)
+	{
+		m_edgeTree->~cb2DynamicTree();
+		cb2Free(m_edgeTree);
+		m_edgeTree = NULL;
+	}
 }
 
 void cb2ChainShape::CreateLoop(const ci::Vec2f* vertices, int count)
@@ -94,11 +149,43 @@ cb2Shape* cb2ChainShape::Clone(cb2BlockAllocator* allocator) const
 	clone->m_nextVertex = m_nextVertex;
 	clone->m_hasPrevVertex = m_hasPrevVertex;
 	clone->m_hasNextVertex = m_hasNextVertex;
+	clone->m_midPhase = m_midPhase;
+
+	if (m_midPhase)
+	{
+		clone->BuildEdgeTree();
+	}
+
 	return clone;
 }
 
+void cb2ChainShape::BuildEdgeTree()
+{
+	void* treeMem = cb2Alloc(sizeof(cb2DynamicTree));
+	m_edgeTree = new (treeMem) cb2DynamicTree;
+
+	m_edgeBounds.lowerBound = m_vertices[0];
+	m_edgeBounds.upperBound = m_vertices[0];
+	for (int i = 0; i < m_count - 1; ++i)
+	{
+		cb2AABB aabb;
+		aabb.lowerBound = cb2Min(m_vertices[i], m_vertices[i + 1]);
+		aabb.upperBound = cb2Max(m_vertices[i], m_vertices[i + 1]);
+		m_edgeTree->CreateProxy(aabb, (void*)(m_vertices + i));
+		m_edgeBounds.Combine(aabb);
+	}
+
+	// The edges never move, so the incremental tree is replaced by a full build.
+	m_edgeTree->Rebuild(true);
+}
+
 int cb2ChainShape::GetChildCount() const
 {
+	if (m_edgeTree != NULL)
+	{
+		return 1;
+	}
+
 	// edge count = vertex count - 1
 	return m_count - 1;
 }
@@ -142,9 +229,63 @@ bool cb2ChainShape::TestPoint(const cb2Transform& xf, const ci::Vec2f& p) const
 	return false;
 }
 
+// Ray casts the edges found in the edge tree, keeping the closest hit.
+struct cb2ChainRayCastWrapper
+{
+	float RayCastCallback(const cb2RayCastInput& input, int proxyId)
+	{
+		const ci::Vec2f* v1 = (const ci::Vec2f*)tree->GetUserData(proxyId);
+
+		cb2EdgeShape edgeShape;
+		edgeShape.m_vertex1 = v1[0];
+		edgeShape.m_vertex2 = v1[1];
+
+		cb2Transform identity;
+		identity.SetIdentity();
+
+		cb2RayCastOutput edgeOutput;
+		if (edgeShape.RayCast(&edgeOutput, input, identity, 0))
+		{
+			*output = edgeOutput;
+			hit = true;
+			return edgeOutput.fraction;
+		}
+
+		return input.maxFraction;
+	}
+
+	const cb2DynamicTree* tree;
+	cb2RayCastOutput* output;
+	bool hit;
+};
+
 bool cb2ChainShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
 							const cb2Transform& xf, int childIndex) const
 {
+	if (m_edgeTree != NULL)
+	{
+		cb2Assert(childIndex == 0);
+
+		// Cast in the chain frame.
+		cb2RayCastInput localInput;
+		localInput.p1 = cb2MulT(xf, input.p1);
+		localInput.p2 = cb2MulT(xf, input.p2);
+		localInput.maxFraction = input.maxFraction;
+
+		cb2ChainRayCastWrapper wrapper;
+		wrapper.tree = m_edgeTree;
+		wrapper.output = output;
+		wrapper.hit = false;
+		m_edgeTree->RayCast(&wrapper, localInput);
+
+		if (wrapper.hit)
+		{
+			output->normal = cb2Mul(xf.q, output->normal);
+		}
+
+		return wrapper.hit;
+	}
+
 	cb2Assert(childIndex < m_count);
 
 	cb2EdgeShape edgeShape;
@@ -164,6 +305,21 @@ bool cb2ChainShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& inp
 
 void cb2ChainShape::ComputeAABB(cb2AABB* aabb, const cb2Transform& xf, int childIndex) const
 {
+	if (m_edgeTree != NULL)
+	{
+		cb2Assert(childIndex == 0);
+
+		// Bound the rotated edge bounds.
+		ci::Vec2f center = cb2Mul(xf, m_edgeBounds.GetCenter());
+		ci::Vec2f h = m_edgeBounds.GetExtents();
+		float c = cb2Abs(xf.q.c);
+		float s = cb2Abs(xf.q.s);
+		ci::Vec2f extents(c * h.x + s * h.y, s * h.x + c * h.y);
+		aabb->lowerBound = center - extents;
+		aabb->upperBound = center + extents;
+		return;
+	}
+
 	cb2Assert(childIndex < m_count);
 
 	int i1 = childIndex;
@@ -20,6 +20,7 @@
 #define CB2_CHAIN_SHAPE_H
 
 #include <CinderBox2D/Collision/Shapes/cb2Shape.h>
+#include <CinderBox2D/Collision/cb2DynamicTree.h>
 
 class cb2EdgeShape;
 
@@ -29,14 +30,21 @@ class cb2EdgeShape;
 /// Since there may be many vertices, they are allocated using cb2Alloc.
 /// Connectivity information is used to create smooth collisions.
 /// WARNING: The chain will not collide properly if there are self-intersections.
+/// Long chains can keep their edges in a local tree, see SetMidPhase.
 class cb2ChainShape : public cb2Shape
 {
 public:
 	cb2ChainShape();
 
-	/// The destructor frees the vertices using cb2Free.
+	/// Copy the vertices, and the edge tree if the other chain has one.
+	cb2ChainShape(const cb2ChainShape& other);
+
+	/// The destructor frees the vertices and the edge tree using cb2Free.
 	~cb2ChainShape();
 
+	/// Replace the vertices and the edge tree by copies of those of the other chain.
+	cb2ChainShape& operator=(const cb2ChainShape& other);
+
 	/// Create a loop. This automatically adjusts connectivity.
 	/// @param vertices an array of vertices, these are copied
 	/// @param count the vertex count
@@ -55,12 +63,32 @@ public:
 	/// Don't call this for loops.
 	void SetNextVertex(const ci::Vec2f& nextVertex);
 
+	/// Keep the edges in a local tree and give the whole chain a single child, so
+	/// it takes one broad-phase proxy. Contacts with single edges are then found by
+	/// querying the local tree. This suits long terrains on static bodies: edge
+	/// contacts are only searched when the other proxy moves in the broad-phase.
+	/// The tree is built by Clone, so set this before creating the fixture.
+	void SetMidPhase(bool flag);
+
+	/// Does this chain keep its edges in a local tree? @see SetMidPhase
+	bool HasMidPhase() const;
+
 	/// Implement cb2Shape. Vertices are cloned using cb2Alloc.
 	cb2Shape* Clone(cb2BlockAllocator* allocator) const;
 
 	/// @see cb2Shape::GetChildCount
+	/// This is one when the chain has a mid-phase.
 	int GetChildCount() const;
 
+	/// Get the number of edges.
+	int GetEdgeCount() const;
+
+	/// Query the edge tree for edges whose AABB overlaps an AABB given in the chain
+	/// frame. The callback is called as bool QueryCallback(int edgeIndex) and may
+	/// return false to stop the query. Requires the mid-phase.
+	template <typename T>
+	void QueryEdges(T* callback, const cb2AABB& aabb) const;
+
 	/// Get a child edge.
 	void GetChildEdge(cb2EdgeShape* edge, int index) const;
 
@@ -68,7 +96,7 @@ public:
 	/// @see cb2Shape::TestPoint
 	bool TestPoint(const cb2Transform& transform, const ci::Vec2f& p) const;
 
-	/// Implement cb2Shape.
+	/// Implement cb2Shape. With the mid-phase this reports the closest edge hit.
 	bool RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
 					const cb2Transform& transform, int childIndex) const;
 
@@ -87,6 +115,20 @@ public:
 
 	ci::Vec2f m_prevVertex, m_nextVertex;
 	bool m_hasPrevVertex, m_hasNextVertex;
+
+	/// Build the edge tree when cloned. @see SetMidPhase
+	bool m_midPhase;
+
+	/// The edge tree and the bounds of all edges in the chain frame. The tree is
+	/// only built on the clone owned by a fixture.
+	cb2DynamicTree* m_edgeTree;
+	cb2AABB m_edgeBounds;
+
+private:
+
+	void Copy(const cb2ChainShape& other);
+	void Free();
+	void BuildEdgeTree();
 };
 
 inline cb2ChainShape::cb2ChainShape()
@@ -97,6 +139,49 @@ inline cb2ChainShape::cb2ChainShape()
 	m_count = 0;
 	m_hasPrevVertex = false;
 	m_hasNextVertex = false;
+	m_midPhase = false;
+	m_edgeTree = NULL;
+}
+
+inline void cb2ChainShape::SetMidPhase(bool flag)
+{
+	m_midPhase = flag;
+}
+
+inline bool cb2ChainShape::HasMidPhase() const
+{
+	return m_edgeTree != NULL;
+}
+
+inline int cb2ChainShape::GetEdgeCount() const
+{
+	return m_count - 1;
+}
+
+/// Maps the tree proxies to edge indices. The proxy user data is the first vertex of the edge.
+template <typename T>
+struct cb2ChainEdgeQueryWrapper
+{
+	bool QueryCallback(int proxyId)
+	{
+		const ci::Vec2f* v1 = (const ci::Vec2f*)tree->GetUserData(proxyId);
+		return callback->QueryCallback(int(v1 - vertices));
+	}
+
+	const cb2DynamicTree* tree;
+	const ci::Vec2f* vertices;
+	T* callback;
+};
+
+template <typename T>
+inline void cb2ChainShape::QueryEdges(T* callback, const cb2AABB& aabb) const
+{
+	cb2Assert(m_edgeTree != NULL);
+	cb2ChainEdgeQueryWrapper<T> wrapper;
+	wrapper.tree = m_edgeTree;
+	wrapper.vertices = m_vertices;
+	wrapper.callback = callback;
+	m_edgeTree->Query(&wrapper, aabb);
 }
 
 #endif
@@ -0,0 +1,403 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <new>
+#include <memory.h>
+
+cb2MeshShape::~cb2MeshShape()
+{
+	cb2Free(m_vertices);
+	cb2Free(m_indices);
+	cb2Free(m_normals);
+	cb2Free(m_adjacency);
+	m_vertices = NULL;
+	m_indices = NULL;
+	m_normals = NULL;
+	m_adjacency = NULL;
+	m_vertexCount = 0;
+	m_pieceCount = 0;
+
+	if (m_tree != NULL)
+	{
+		m_tree->~cb2DynamicTree();
+		cb2Free(m_tree);
+		m_tree = NULL;
+	}
+}
+
+void cb2MeshShape::Allocate(const ci::Vec2f* vertices, int vertexCount, const int* indices, int pieceCount, int pieceSize)
+{
+	cb2Assert(m_vertices == NULL && m_pieceCount == 0);
+	cb2Assert(vertexCount >= pieceSize && pieceCount >= 1);
+
+	m_vertexCount = vertexCount;
+	m_vertices = (ci::Vec2f*)cb2Alloc(vertexCount * sizeof(ci::Vec2f));
+	memcpy(m_vertices, vertices, vertexCount * sizeof(ci::Vec2f));
+
+	m_pieceCount = pieceCount;
+	m_pieceSize = pieceSize;
+	m_indices = (int*)cb2Alloc(pieceSize * pieceCount * sizeof(int));
+	memcpy(m_indices, indices, pieceSize * pieceCount * sizeof(int));
+
+	for (int i = 0; i < pieceSize * pieceCount; ++i)
+	{
+		cb2Assert(0 <= m_indices[i] && m_indices[i] < vertexCount);
+	}
+}
+
+void cb2MeshShape::CreateSegments(const ci::Vec2f* vertices, int vertexCount, const int* indices, int segmentCount)
+{
+	Allocate(vertices, vertexCount, indices, segmentCount, 2);
+
+	// Count the segments entering and leaving each vertex.
+	int* buffer = (int*)cb2Alloc(4 * vertexCount * sizeof(int));
+	int* inCount = buffer;
+	int* outCount = buffer + vertexCount;
+	int* inSegment = buffer + 2 * vertexCount;
+	int* outSegment = buffer + 3 * vertexCount;
+	memset(inCount, 0, 2 * vertexCount * sizeof(int));
+
+	for (int i = 0; i < segmentCount; ++i)
+	{
+		int i1 = m_indices[2 * i + 0];
+		int i2 = m_indices[2 * i + 1];
+
+		// If the code crashes here, it means your vertices are too close together.
+		cb2Assert(cb2DistanceSquared(m_vertices[i1], m_vertices[i2]) > cb2_linearSlop * cb2_linearSlop);
+
+		++outCount[i1];
+		outSegment[i1] = i;
+		++inCount[i2];
+		inSegment[i2] = i;
+	}
+
+	// Connect the segments through vertices without branches.
+	m_adjacency = (int*)cb2Alloc(2 * segmentCount * sizeof(int));
+	for (int i = 0; i < segmentCount; ++i)
+	{
+		int i1 = m_indices[2 * i + 0];
+		int i2 = m_indices[2 * i + 1];
+
+		bool linked1 = inCount[i1] == 1 && outCount[i1] == 1;
+		bool linked2 = inCount[i2] == 1 && outCount[i2] == 1;
+		m_adjacency[2 * i + 0] = linked1 ? inSegment[i1] : -1;
+		m_adjacency[2 * i + 1] = linked2 ? outSegment[i2] : -1;
+	}
+
+	cb2Free(buffer);
+
+	BuildTree();
+}
+
+void cb2MeshShape::CreateTriangles(const ci::Vec2f* vertices, int vertexCount, const int* indices, int triangleCount)
+{
+	Allocate(vertices, vertexCount, indices, triangleCount, 3);
+
+	m_normals = (ci::Vec2f*)cb2Alloc(3 * triangleCount * sizeof(ci::Vec2f));
+	for (int i = 0; i < triangleCount; ++i)
+	{
+		int* triangle = m_indices + 3 * i;
+		ci::Vec2f e1 = m_vertices[triangle[1]] - m_vertices[triangle[0]];
+		ci::Vec2f e2 = m_vertices[triangle[2]] - m_vertices[triangle[0]];
+		float area = cb2Cross(e1, e2);
+
+		// If the code crashes here, it means your triangle is degenerate.
+		cb2Assert(cb2Abs(area) > cb2_epsilon);
+
+		// Store the triangles counter-clockwise.
+		if (area < 0.0f)
+		{
+			int index = triangle[1];
+			triangle[1] = triangle[2];
+			triangle[2] = index;
+		}
+
+		for (int j = 0; j < 3; ++j)
+		{
+			int j2 = j + 1 < 3 ? j + 1 : 0;
+			ci::Vec2f edge = m_vertices[triangle[j2]] - m_vertices[triangle[j]];
+			cb2Assert(edge.lengthSquared() > cb2_epsilon * cb2_epsilon);
+			ci::Vec2f normal = cb2Cross(edge, 1.0f);
+			normal.normalize();
+			m_normals[3 * i + j] = normal;
+		}
+	}
+
+	BuildTree();
+}
+
+void cb2MeshShape::BuildTree()
+{
+	void* treeMem = cb2Alloc(sizeof(cb2DynamicTree));
+	m_tree = new (treeMem) cb2DynamicTree;
+
+	cb2Transform identity;
+	identity.SetIdentity();
+
+	for (int i = 0; i < m_pieceCount; ++i)
+	{
+		cb2AABB aabb;
+		ComputePieceAABB(&aabb, identity, i);
+		m_tree->CreateProxy(aabb, (void*)(m_indices + m_pieceSize * i));
+
+		if (i == 0)
+		{
+			m_bounds = aabb;
+		}
+		else
+		{
+			m_bounds.Combine(aabb);
+		}
+	}
+
+	// The mesh never changes, so the incremental tree is replaced by a full build.
+	m_tree->Rebuild(true);
+}
+
+cb2Shape* cb2MeshShape::Clone(cb2BlockAllocator* allocator) const
+{
+	void* mem = allocator->Allocate(sizeof(cb2MeshShape));
+	cb2MeshShape* clone = new (mem) cb2MeshShape;
+	clone->m_radius = m_radius;
+	clone->Allocate(m_vertices, m_vertexCount, m_indices, m_pieceCount, m_pieceSize);
+
+	if (m_normals != NULL)
+	{
+		clone->m_normals = (ci::Vec2f*)cb2Alloc(3 * m_pieceCount * sizeof(ci::Vec2f));
+		memcpy(clone->m_normals, m_normals, 3 * m_pieceCount * sizeof(ci::Vec2f));
+	}
+
+	if (m_adjacency != NULL)
+	{
+		clone->m_adjacency = (int*)cb2Alloc(2 * m_pieceCount * sizeof(int));
+		memcpy(clone->m_adjacency, m_adjacency, 2 * m_pieceCount * sizeof(int));
+	}
+
+	clone->BuildTree();
+	return clone;
+}
+
+int cb2MeshShape::GetChildCount() const
+{
+	return 1;
+}
+
+void cb2MeshShape::GetChildEdge(cb2EdgeShape* edge, int index) const
+{
+	cb2Assert(m_pieceSize == 2);
+	cb2Assert(0 <= index && index < m_pieceCount);
+	edge->m_type = cb2Shape::e_edge;
+	edge->m_radius = m_radius;
+
+	edge->m_vertex1 = m_vertices[m_indices[2 * index + 0]];
+	edge->m_vertex2 = m_vertices[m_indices[2 * index + 1]];
+
+	int prev = m_adjacency[2 * index + 0];
+	if (prev != -1)
+	{
+		edge->m_vertex0 = m_vertices[m_indices[2 * prev + 0]];
+		edge->m_hasVertex0 = true;
+	}
+	else
+	{
+		edge->m_hasVertex0 = false;
+	}
+
+	int next = m_adjacency[2 * index + 1];
+	if (next != -1)
+	{
+		edge->m_vertex3 = m_vertices[m_indices[2 * next + 1]];
+		edge->m_hasVertex3 = true;
+	}
+	else
+	{
+		edge->m_hasVertex3 = false;
+	}
+}
+
+void cb2MeshShape::GetChildPolygon(cb2PolygonShape* polygon, int index) const
+{
+	cb2Assert(m_pieceSize == 3);
+	cb2Assert(0 <= index && index < m_pieceCount);
+	polygon->m_radius = m_radius;
+	polygon->m_count = 3;
+
+	const int* triangle = m_indices + 3 * index;
+	for (int i = 0; i < 3; ++i)
+	{
+		polygon->m_vertices[i] = m_vertices[triangle[i]];
+		polygon->m_normals[i] = m_normals[3 * index + i];
+	}
+
+	polygon->m_centroid = (1.0f / 3.0f) * (polygon->m_vertices[0] + polygon->m_vertices[1] + polygon->m_vertices[2]);
+}
+
+void cb2MeshShape::ComputePieceAABB(cb2AABB* aabb, const cb2Transform& xf, int index) const
+{
+	cb2Assert(0 <= index && index < m_pieceCount);
+	const int* piece = m_indices + m_pieceSize * index;
+
+	ci::Vec2f lower = cb2Mul(xf, m_vertices[piece[0]]);
+	ci::Vec2f upper = lower;
+	for (int i = 1; i < m_pieceSize; ++i)
+	{
+		ci::Vec2f v = cb2Mul(xf, m_vertices[piece[i]]);
+		lower = cb2Min(lower, v);
+		upper = cb2Max(upper, v);
+	}
+
+	ci::Vec2f r(m_radius, m_radius);
+	aabb->lowerBound = lower - r;
+	aabb->upperBound = upper + r;
+}
+
+// Tests a point against the triangles found in the tree.
+struct cb2MeshPointQuery
+{
+	bool QueryCallback(int index)
+	{
+		const int* triangle = mesh->m_indices + 3 * index;
+		const ci::Vec2f* normals = mesh->m_normals + 3 * index;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (cb2Dot(normals[i], point - mesh->m_vertices[triangle[i]]) > 0.0f)
+			{
+				return true;
+			}
+		}
+
+		inside = true;
+		return false;
+	}
+
+	const cb2MeshShape* mesh;
+	ci::Vec2f point;
+	bool inside;
+};
+
+bool cb2MeshShape::TestPoint(const cb2Transform& xf, const ci::Vec2f& p) const
+{
+	if (m_pieceSize == 2)
+	{
+		return false;
+	}
+
+	cb2MeshPointQuery query;
+	query.mesh = this;
+	query.point = cb2MulT(xf, p);
+	query.inside = false;
+
+	cb2AABB aabb;
+	aabb.lowerBound = query.point;
+	aabb.upperBound = query.point;
+	QueryPieces(&query, aabb);
+
+	return query.inside;
+}
+
+// Ray casts the pieces found in the tree, keeping the closest hit.
+struct cb2MeshRayCastWrapper
+{
+	float RayCastCallback(const cb2RayCastInput& input, int proxyId)
+	{
+		const int* first = (const int*)mesh->m_tree->GetUserData(proxyId);
+		int index = int(first - mesh->m_indices) / mesh->m_pieceSize;
+
+		cb2Transform identity;
+		identity.SetIdentity();
+
+		cb2RayCastOutput pieceOutput;
+		bool pieceHit;
+		if (mesh->HasSegments())
+		{
+			cb2EdgeShape edge;
+			mesh->GetChildEdge(&edge, index);
+			pieceHit = edge.RayCast(&pieceOutput, input, identity, 0);
+		}
+		else
+		{
+			cb2PolygonShape polygon;
+			mesh->GetChildPolygon(&polygon, index);
+			pieceHit = polygon.RayCast(&pieceOutput, input, identity, 0);
+		}
+
+		if (pieceHit)
+		{
+			*output = pieceOutput;
+			hit = true;
+			return pieceOutput.fraction;
+		}
+
+		return input.maxFraction;
+	}
+
+	const cb2MeshShape* mesh;
+	cb2RayCastOutput* output;
+	bool hit;
+};
+
+bool cb2MeshShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
+							const cb2Transform& xf, int childIndex) const
+{
+	CB2_NOT_USED(childIndex);
+
+	// Cast in the mesh frame.
+	cb2RayCastInput localInput;
+	localInput.p1 = cb2MulT(xf, input.p1);
+	localInput.p2 = cb2MulT(xf, input.p2);
+	localInput.maxFraction = input.maxFraction;
+
+	cb2MeshRayCastWrapper wrapper;
+	wrapper.mesh = this;
+	wrapper.output = output;
+	wrapper.hit = false;
+	m_tree->RayCast(&wrapper, localInput);
+
+	if (wrapper.hit)
+	{
+		output->normal = cb2Mul(xf.q, output->normal);
+	}
+
+	return wrapper.hit;
+}
+
+void cb2MeshShape::ComputeAABB(cb2AABB* aabb, const cb2Transform& xf, int childIndex) const
+{
+	CB2_NOT_USED(childIndex);
+
+	// Bound the rotated mesh bounds.
+	ci::Vec2f center = cb2Mul(xf, m_bounds.GetCenter());
+	ci::Vec2f h = m_bounds.GetExtents();
+	float c = cb2Abs(xf.q.c);
+	float s = cb2Abs(xf.q.s);
+	ci::Vec2f extents(c * h.x + s * h.y, s * h.x + c * h.y);
+	aabb->lowerBound = center - extents;
+	aabb->upperBound = center + extents;
+}
+
+void cb2MeshShape::ComputeMass(cb2MassData* massData, float density) const
+{
+	CB2_NOT_USED(density);
+
+	massData->mass = 0.0f;
+	cb2::setZero(massData->center);
+	massData->I = 0.0f;
+}
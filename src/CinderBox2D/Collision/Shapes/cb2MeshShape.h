@@ -0,0 +1,183 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef CB2_MESH_SHAPE_H
+#define CB2_MESH_SHAPE_H
+
+#include <CinderBox2D/Collision/Shapes/cb2Shape.h>
+#include <CinderBox2D/Collision/cb2DynamicTree.h>
+
+class cb2EdgeShape;
+class cb2PolygonShape;
+
+/// A static mesh of line segments or triangles for level geometry. The mesh is
+/// built once from a vertex and an index buffer and keeps its pieces in a local
+/// tree, so it takes a single broad-phase proxy. Contacts with single pieces are
+/// found by querying the tree, and the contact child index is the piece index.
+/// Segments that share a vertex index are connected through ghost vertices for
+/// smooth collision, like the edges of a chain.
+/// Meshes have no mass and are meant for static bodies.
+/// Since there may be many pieces, the buffers are allocated using cb2Alloc.
+class cb2MeshShape : public cb2Shape
+{
+public:
+	cb2MeshShape();
+
+	/// The destructor frees the buffers and the tree using cb2Free.
+	~cb2MeshShape();
+
+	/// Create a segment mesh. A vertex that ends exactly one segment and starts
+	/// exactly one other connects the two for smooth collision.
+	/// @param vertices an array of vertices, these are copied
+	/// @param vertexCount the vertex count
+	/// @param indices two vertex indices per segment, these are copied
+	/// @param segmentCount the segment count
+	void CreateSegments(const ci::Vec2f* vertices, int vertexCount, const int* indices, int segmentCount);
+
+	/// Create a triangle mesh. Triangles may use any winding order.
+	/// @param vertices an array of vertices, these are copied
+	/// @param vertexCount the vertex count
+	/// @param indices three vertex indices per triangle, these are copied
+	/// @param triangleCount the triangle count
+	void CreateTriangles(const ci::Vec2f* vertices, int vertexCount, const int* indices, int triangleCount);
+
+	/// Implement cb2Shape. Buffers are cloned using cb2Alloc.
+	cb2Shape* Clone(cb2BlockAllocator* allocator) const;
+
+	/// The whole mesh is one child.
+	/// @see cb2Shape::GetChildCount
+	int GetChildCount() const;
+
+	/// Get the number of segments or triangles.
+	int GetPieceCount() const;
+
+	/// Is this a segment mesh?
+	bool HasSegments() const;
+
+	/// Get a segment with its ghost vertices. Segment meshes only.
+	void GetChildEdge(cb2EdgeShape* edge, int index) const;
+
+	/// Get a triangle as a polygon. Triangle meshes only.
+	void GetChildPolygon(cb2PolygonShape* polygon, int index) const;
+
+	/// Compute the world AABB of a piece.
+	void ComputePieceAABB(cb2AABB* aabb, const cb2Transform& transform, int index) const;
+
+	/// Query the tree for pieces whose AABB overlaps an AABB given in the mesh
+	/// frame. The callback is called as bool QueryCallback(int pieceIndex) and
+	/// may return false to stop the query.
+	template <typename T>
+	void QueryPieces(T* callback, const cb2AABB& aabb) const;
+
+	/// Test a point against the triangles. Always false for segment meshes.
+	/// @see cb2Shape::TestPoint
+	bool TestPoint(const cb2Transform& transform, const ci::Vec2f& p) const;
+
+	/// Implement cb2Shape. This reports the closest piece hit.
+	bool RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
+					const cb2Transform& transform, int childIndex) const;
+
+	/// @see cb2Shape::ComputeAABB
+	void ComputeAABB(cb2AABB* aabb, const cb2Transform& transform, int childIndex) const;
+
+	/// Meshes have zero mass.
+	/// @see cb2Shape::ComputeMass
+	void ComputeMass(cb2MassData* massData, float density) const;
+
+	/// The vertices. Owned by this class.
+	ci::Vec2f* m_vertices;
+	int m_vertexCount;
+
+	/// The vertex indices, m_pieceSize per piece. Triangles are counter-clockwise.
+	int* m_indices;
+	int m_pieceCount;
+
+	/// 2 for segments, 3 for triangles.
+	int m_pieceSize;
+
+	/// The outward normals of the triangles, three per triangle.
+	/// NULL for segment meshes.
+	ci::Vec2f* m_normals;
+
+	/// The previous and next segment of each segment, or -1 when not connected.
+	/// NULL for triangle meshes.
+	int* m_adjacency;
+
+	/// The piece tree and the bounds of all vertices in the mesh frame.
+	cb2DynamicTree* m_tree;
+	cb2AABB m_bounds;
+
+private:
+
+	void Allocate(const ci::Vec2f* vertices, int vertexCount, const int* indices, int pieceCount, int pieceSize);
+	void BuildTree();
+};
+
+inline cb2MeshShape::cb2MeshShape()
+{
+	m_type = e_mesh;
+	m_radius = cb2_polygonRadius;
+	m_vertices = NULL;
+	m_vertexCount = 0;
+	m_indices = NULL;
+	m_pieceCount = 0;
+	m_pieceSize = 0;
+	m_normals = NULL;
+	m_adjacency = NULL;
+	m_tree = NULL;
+}
+
+inline int cb2MeshShape::GetPieceCount() const
+{
+	return m_pieceCount;
+}
+
+inline bool cb2MeshShape::HasSegments() const
+{
+	return m_pieceSize == 2;
+}
+
+/// Maps the tree proxies to piece indices. The proxy user data is the first index of the piece.
+template <typename T>
+struct cb2MeshPieceQueryWrapper
+{
+	bool QueryCallback(int proxyId)
+	{
+		const int* first = (const int*)tree->GetUserData(proxyId);
+		return callback->QueryCallback(int(first - indices) / pieceSize);
+	}
+
+	const cb2DynamicTree* tree;
+	const int* indices;
+	int pieceSize;
+	T* callback;
+};
+
+template <typename T>
+inline void cb2MeshShape::QueryPieces(T* callback, const cb2AABB& aabb) const
+{
+	cb2Assert(m_tree != NULL);
+	cb2MeshPieceQueryWrapper<T> wrapper;
+	wrapper.tree = m_tree;
+	wrapper.indices = m_indices;
+	wrapper.pieceSize = m_pieceSize;
+	wrapper.callback = callback;
+	m_tree->Query(&wrapper, aabb);
+}
+
+#endif
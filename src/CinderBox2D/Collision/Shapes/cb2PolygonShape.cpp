@@ -244,16 +244,100 @@ bool cb2PolygonShape::TestPoint(const cb2Transform& xf, const ci::Vec2f& p) cons
 {
 	ci::Vec2f pLocal = cb2MulT(xf.q, p - xf.p);
 
+	bool inside = true;
 	for (int i = 0; i < m_count; ++i)
 	{
 		float dot = cb2Dot(m_normals[i], pLocal - m_vertices[i]);
 		if (dot > 0.0f)
 		{
-			return false;
+			inside = false;
+			break;
 		}
 	}
 
-	return true;
+	float rounding = GetRounding();
+	if (inside || rounding == 0.0f)
+	{
+		return inside;
+	}
+
+	// Outside the core, so the point is in the rounding if it is close to an edge.
+	for (int i = 0; i < m_count; ++i)
+	{
+		ci::Vec2f v1 = m_vertices[i];
+		ci::Vec2f e = (i + 1 < m_count ? m_vertices[i + 1] : m_vertices[0]) - v1;
+		float s = cb2Clamp(cb2Dot(pLocal - v1, e) / cb2Dot(e, e), 0.0f, 1.0f);
+		if (cb2DistanceSquared(pLocal, v1 + s * e) <= rounding * rounding)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// A ray that starts outside a rounded polygon enters through one of the edges
+// pushed out by the rounding or through one of the circles at the vertices.
+static bool cb2RayCastRounded(cb2RayCastOutput* output, const cb2PolygonShape* polygon,
+							  const ci::Vec2f& p1, const ci::Vec2f& d, float maxFraction, float rounding)
+{
+	int count = polygon->m_count;
+	const ci::Vec2f* vertices = polygon->m_vertices;
+	const ci::Vec2f* normals = polygon->m_normals;
+
+	float dd = cb2Dot(d, d);
+	if (dd < cb2_epsilon)
+	{
+		return false;
+	}
+
+	float fraction = maxFraction;
+	ci::Vec2f normal;
+	bool hit = false;
+
+	for (int i = 0; i < count; ++i)
+	{
+		// The edge pushed out along its normal.
+		float denominator = cb2Dot(normals[i], d);
+		if (denominator < 0.0f)
+		{
+			ci::Vec2f a = vertices[i] + rounding * normals[i];
+			ci::Vec2f e = (i + 1 < count ? vertices[i + 1] : vertices[0]) - vertices[i];
+			float t = cb2Dot(normals[i], a - p1) / denominator;
+			float u = cb2Dot(p1 + t * d - a, e);
+			if (0.0f <= t && t <= fraction && 0.0f <= u && u <= cb2Dot(e, e))
+			{
+				fraction = t;
+				normal = normals[i];
+				hit = true;
+			}
+		}
+
+		// The vertex circle, as in cb2CircleShape::RayCast.
+		ci::Vec2f s = p1 - vertices[i];
+		float b = cb2Dot(s, s) - rounding * rounding;
+		float c = cb2Dot(s, d);
+		float sigma = c * c - dd * b;
+		if (sigma >= 0.0f)
+		{
+			float a = -(c + cb2Sqrt(sigma));
+			if (0.0f <= a && a <= fraction * dd)
+			{
+				fraction = a / dd;
+				normal = s + fraction * d;
+				normal.normalize();
+				hit = true;
+			}
+		}
+	}
+
+	if (hit)
+	{
+		output->fraction = fraction;
+		output->normal = normal;
+	}
+
+	return hit;
 }
 
 bool cb2PolygonShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& input,
@@ -266,6 +350,20 @@ bool cb2PolygonShape::RayCast(cb2RayCastOutput* output, const cb2RayCastInput& i
 	ci::Vec2f p2 = cb2MulT(xf.q, input.p2 - xf.p);
 	ci::Vec2f d = p2 - p1;
 
+	float rounding = GetRounding();
+	if (rounding > 0.0f)
+	{
+		cb2Transform identity;
+		identity.SetIdentity();
+		if (TestPoint(identity, p1) || cb2RayCastRounded(output, this, p1, d, input.maxFraction, rounding) == false)
+		{
+			return false;
+		}
+
+		output->normal = cb2Mul(xf.q, output->normal);
+		return true;
+	}
+
 	float lower = 0.0f, upper = input.maxFraction;
 
 	int index = -1;
@@ -375,6 +473,23 @@ void cb2PolygonShape::ComputeMass(cb2MassData* massData, float density) const
 
 	cb2Assert(m_count >= 3);
 
+	// The rounding is approximated by pushing the edges out by the rounding,
+	// which squares off the corners.
+	ci::Vec2f roundedVertices[cb2_maxPolygonVertices];
+	const ci::Vec2f* vertices = m_vertices;
+	float rounding = GetRounding();
+	if (rounding > 0.0f)
+	{
+		for (int i = 0; i < m_count; ++i)
+		{
+			const ci::Vec2f& n1 = m_normals[i > 0 ? i - 1 : m_count - 1];
+			const ci::Vec2f& n2 = m_normals[i];
+			roundedVertices[i] = m_vertices[i] + (rounding / (1.0f + cb2Dot(n1, n2))) * (n1 + n2);
+		}
+
+		vertices = roundedVertices;
+	}
+
 	ci::Vec2f center; center.set(0.0f, 0.0f);
 	float area = 0.0f;
 	float I = 0.0f;
@@ -386,7 +501,7 @@ void cb2PolygonShape::ComputeMass(cb2MassData* massData, float density) const
 	// This code would put the reference point inside the polygon.
 	for (int i = 0; i < m_count; ++i)
 	{
-		s += m_vertices[i];
+		s += vertices[i];
 	}
 	s *= 1.0f / m_count;
 
@@ -395,8 +510,8 @@ void cb2PolygonShape::ComputeMass(cb2MassData* massData, float density) const
 	for (int i = 0; i < m_count; ++i)
 	{
 		// Triangle vertices.
-		ci::Vec2f e1 = m_vertices[i] - s;
-		ci::Vec2f e2 = i + 1 < m_count ? m_vertices[i+1] - s : m_vertices[0] - s;
+		ci::Vec2f e1 = vertices[i] - s;
+		ci::Vec2f e2 = i + 1 < m_count ? vertices[i+1] - s : vertices[0] - s;
 
 		float D = cb2Cross(e1, e2);
 
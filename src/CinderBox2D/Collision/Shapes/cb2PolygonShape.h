@@ -55,6 +55,14 @@ public:
 	/// @param angle the rotation of the box in local coordinates.
 	void SetAsBox(float hx, float hy, const ci::Vec2f& center, float angle);
 
+	/// Round the corners of the polygon. The default radius is the cb2_polygonRadius
+	/// skin. The collision routines use the full radius while the rounding beyond
+	/// the skin also counts for mass, point tests, and ray casts.
+	void SetRadius(float radius);
+
+	/// Get the rounding beyond the cb2_polygonRadius skin.
+	float GetRounding() const;
+
 	/// @see cb2Shape::TestPoint
 	bool TestPoint(const cb2Transform& transform, const ci::Vec2f& p) const;
 
@@ -91,6 +99,17 @@ inline cb2PolygonShape::cb2PolygonShape()
 	m_count = 0;
 }
 
+inline void cb2PolygonShape::SetRadius(float radius)
+{
+	cb2Assert(radius >= 0.0f);
+	m_radius = radius;
+}
+
+inline float cb2PolygonShape::GetRounding() const
+{
+	return cb2Max(m_radius - cb2_polygonRadius, 0.0f);
+}
+
 inline const ci::Vec2f& cb2PolygonShape::GetVertex(int index) const
 {
 	cb2Assert(0 <= index && index < m_count);
@@ -20,11 +20,13 @@
 
 cb2BroadPhase::cb2BroadPhase()
 {
+	m_backend = &m_treeBackend;
 	m_proxyCount = 0;
 
 	m_pairCapacity = 16;
 	m_pairCount = 0;
-	m_pairBuffer = (cb2Pair*)cb2Alloc(m_pairCapacity * sizeof(cb2Pair));
+	m_pairBuffer = (cb2PairKey*)cb2Alloc(m_pairCapacity * sizeof(cb2PairKey));
+	m_pairScratch = (cb2PairKey*)cb2Alloc(m_pairCapacity * sizeof(cb2PairKey));
 
 	m_moveCapacity = 16;
 	m_moveCount = 0;
@@ -34,12 +36,13 @@ cb2BroadPhase::cb2BroadPhase()
 cb2BroadPhase::~cb2BroadPhase()
 {
 	cb2Free(m_moveBuffer);
+	cb2Free(m_pairScratch);
 	cb2Free(m_pairBuffer);
 }
 
 int cb2BroadPhase::CreateProxy(const cb2AABB& aabb, void* userData)
 {
-	int proxyId = m_tree.CreateProxy(aabb, userData);
+	int proxyId = m_backend->CreateProxy(aabb, userData);
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
@@ -49,18 +52,25 @@ void cb2BroadPhase::DestroyProxy(int proxyId)
 {
 	UnBufferMove(proxyId);
 	--m_proxyCount;
-	m_tree.DestroyProxy(proxyId);
+	m_backend->DestroyProxy(proxyId);
 }
 
 void cb2BroadPhase::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer = m_backend->MoveProxy(proxyId, aabb, displacement);
 	if (buffer)
 	{
 		BufferMove(proxyId);
 	}
 }
 
+void cb2BroadPhase::SetBackend(cb2BroadPhaseBackend* backend)
+{
+	cb2Assert(m_proxyCount == 0);
+	m_backend = backend ? backend : &m_treeBackend;
+	m_moveCount = 0;
+}
+
 void cb2BroadPhase::TouchProxy(int proxyId)
 {
 	BufferMove(proxyId);
@@ -92,28 +102,61 @@ void cb2BroadPhase::UnBufferMove(int proxyId)
 	}
 }
 
-// This is called from cb2DynamicTree::Query when we are gathering pairs.
-bool cb2BroadPhase::QueryCallback(int proxyId)
+// Sort the pair keys with an LSD radix sort on bytes. The keys are
+// integers, so the order matches sorting by (proxyIdA, proxyIdB).
+void cb2BroadPhase::SortPairs()
 {
-	// A proxy cannot form a pair with itself.
-	if (proxyId == m_queryProxyId)
+	// Small buffers are faster with a comparison sort.
+	if (m_pairCount < 256)
 	{
-		return true;
+		std::sort(m_pairBuffer, m_pairBuffer + m_pairCount);
+		return;
 	}
 
-	// Grow the pair buffer as needed.
-	if (m_pairCount == m_pairCapacity)
+	// Histogram all eight digits in one pass.
+	int counts[8][256];
+	memset(counts, 0, sizeof(counts));
+	for (int i = 0; i < m_pairCount; ++i)
 	{
-		cb2Pair* oldBuffer = m_pairBuffer;
-		m_pairCapacity *= 2;
-		m_pairBuffer = (cb2Pair*)cb2Alloc(m_pairCapacity * sizeof(cb2Pair));
-		memcpy(m_pairBuffer, oldBuffer, m_pairCount * sizeof(cb2Pair));
-		cb2Free(oldBuffer);
+		cb2PairKey key = m_pairBuffer[i];
+		for (int pass = 0; pass < 8; ++pass)
+		{
+			++counts[pass][(key >> (8 * pass)) & 0xff];
+		}
 	}
 
-	m_pairBuffer[m_pairCount].proxyIdA = cb2Min(proxyId, m_queryProxyId);
-	m_pairBuffer[m_pairCount].proxyIdB = cb2Max(proxyId, m_queryProxyId);
-	++m_pairCount;
+	cb2PairKey* source = m_pairBuffer;
+	cb2PairKey* target = m_pairScratch;
+	for (int pass = 0; pass < 8; ++pass)
+	{
+		int* count = counts[pass];
+		int shift = 8 * pass;
+
+		// Skip digits shared by all keys, such as the high bytes of small ids.
+		if (count[(source[0] >> shift) & 0xff] == m_pairCount)
+		{
+			continue;
+		}
 
-	return true;
+		int offset = 0;
+		for (int digit = 0; digit < 256; ++digit)
+		{
+			int n = count[digit];
+			count[digit] = offset;
+			offset += n;
+		}
+
+		for (int i = 0; i < m_pairCount; ++i)
+		{
+			cb2PairKey key = source[i];
+			target[count[(key >> shift) & 0xff]++] = key;
+		}
+
+		cb2Swap(source, target);
+	}
+
+	if (source != m_pairBuffer)
+	{
+		memcpy(m_pairBuffer, source, m_pairCount * sizeof(cb2PairKey));
+	}
 }
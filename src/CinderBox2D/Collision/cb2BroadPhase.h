@@ -21,19 +21,54 @@
 
 #include <CinderBox2D/Common/cb2Settings.h>
 #include <CinderBox2D/Collision/cb2Collision.h>
-#include <CinderBox2D/Collision/cb2DynamicTree.h>
+#include <CinderBox2D/Collision/cb2DynamicTreeBroadPhase.h>
 #include <algorithm>
 
-struct cb2Pair
+/// A candidate pair packed as (proxyIdA << 32) | proxyIdB with proxyIdA < proxyIdB.
+/// Sorting the keys as integers orders the pairs by proxyIdA, then proxyIdB.
+typedef unsigned long long cb2PairKey;
+
+inline cb2PairKey cb2MakePairKey(int proxyIdA, int proxyIdB)
+{
+	return ((cb2PairKey)(unsigned int)proxyIdA << 32) | (cb2PairKey)(unsigned int)proxyIdB;
+}
+
+/// Adapts a template query callback to cb2BroadPhaseCallback.
+template <typename T>
+class cb2BroadPhaseQueryAdapter : public cb2BroadPhaseCallback
 {
-	int proxyIdA;
-	int proxyIdB;
-	int next;
+public:
+	explicit cb2BroadPhaseQueryAdapter(T* callback) : m_callback(callback) {}
+
+	bool QueryCallback(int proxyId)
+	{
+		return m_callback->QueryCallback(proxyId);
+	}
+
+private:
+	T* m_callback;
+};
+
+/// Adapts a template ray-cast callback to cb2BroadPhaseCallback.
+template <typename T>
+class cb2BroadPhaseRayCastAdapter : public cb2BroadPhaseCallback
+{
+public:
+	explicit cb2BroadPhaseRayCastAdapter(T* callback) : m_callback(callback) {}
+
+	float RayCastCallback(const cb2RayCastInput& input, int proxyId)
+	{
+		return m_callback->RayCastCallback(input, proxyId);
+	}
+
+private:
+	T* m_callback;
 };
 
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
+/// The proxies live in a cb2BroadPhaseBackend. By default this is a dynamic tree.
 class cb2BroadPhase
 {
 public:
@@ -105,16 +140,31 @@ public:
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const ci::Vec2f& newOrigin);
 
-private:
+	/// Let the backend maintain its structure. Called by the world once per time step.
+	void Maintain();
+
+	/// Replace the backend. Pass NULL to restore the default dynamic tree.
+	/// The backend is owned by you and must remain in scope.
+	/// @warning the broad-phase must not contain any proxies.
+	void SetBackend(cb2BroadPhaseBackend* backend);
+
+	/// Get the active backend.
+	const cb2BroadPhaseBackend* GetBackend() const;
 
-	friend class cb2DynamicTree;
+	/// Add a candidate pair to the pair buffer. Called by backends from FindPairs.
+	/// Duplicates are removed before pairs reach the client.
+	void BufferPair(int proxyIdA, int proxyIdB);
+
+private:
 
 	void BufferMove(int proxyId);
 	void UnBufferMove(int proxyId);
 
-	bool QueryCallback(int proxyId);
+	// Sort the pair buffer to expose duplicates.
+	void SortPairs();
 
-	cb2DynamicTree m_tree;
+	cb2DynamicTreeBroadPhase m_treeBackend;
+	cb2BroadPhaseBackend* m_backend;
 
 	int m_proxyCount;
 
@@ -122,44 +172,27 @@ private:
 	int m_moveCapacity;
 	int m_moveCount;
 
-	cb2Pair* m_pairBuffer;
+	cb2PairKey* m_pairBuffer;
+	cb2PairKey* m_pairScratch;
 	int m_pairCapacity;
 	int m_pairCount;
-
-	int m_queryProxyId;
 };
 
-/// This is used to sort pairs.
-inline bool cb2PairLessThan(const cb2Pair& pair1, const cb2Pair& pair2)
-{
-	if (pair1.proxyIdA < pair2.proxyIdA)
-	{
-		return true;
-	}
-
-	if (pair1.proxyIdA == pair2.proxyIdA)
-	{
-		return pair1.proxyIdB < pair2.proxyIdB;
-	}
-
-	return false;
-}
-
 inline void* cb2BroadPhase::GetUserData(int proxyId) const
 {
-	return m_tree.GetUserData(proxyId);
+	return m_backend->GetUserData(proxyId);
 }
 
 inline bool cb2BroadPhase::TestOverlap(int proxyIdA, int proxyIdB) const
 {
-	const cb2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
-	const cb2AABB& aabbB = m_tree.GetFatAABB(proxyIdB);
+	const cb2AABB& aabbA = m_backend->GetFatAABB(proxyIdA);
+	const cb2AABB& aabbB = m_backend->GetFatAABB(proxyIdB);
 	return cb2TestOverlap(aabbA, aabbB);
 }
 
 inline const cb2AABB& cb2BroadPhase::GetFatAABB(int proxyId) const
 {
-	return m_tree.GetFatAABB(proxyId);
+	return m_backend->GetFatAABB(proxyId);
 }
 
 inline int cb2BroadPhase::GetProxyCount() const
@@ -169,17 +202,41 @@ inline int cb2BroadPhase::GetProxyCount() const
 
 inline int cb2BroadPhase::GetTreeHeight() const
 {
-	return m_tree.GetHeight();
+	return m_backend->GetHeight();
 }
 
 inline int cb2BroadPhase::GetTreeBalance() const
 {
-	return m_tree.GetMaxBalance();
+	return m_backend->GetMaxBalance();
 }
 
 inline float cb2BroadPhase::GetTreeQuality() const
 {
-	return m_tree.GetAreaRatio();
+	return m_backend->GetAreaRatio();
+}
+
+inline const cb2BroadPhaseBackend* cb2BroadPhase::GetBackend() const
+{
+	return m_backend;
+}
+
+inline void cb2BroadPhase::BufferPair(int proxyIdA, int proxyIdB)
+{
+	// Grow the pair buffer as needed. The sort scratch grows along.
+	if (m_pairCount == m_pairCapacity)
+	{
+		cb2PairKey* oldBuffer = m_pairBuffer;
+		m_pairCapacity *= 2;
+		m_pairBuffer = (cb2PairKey*)cb2Alloc(m_pairCapacity * sizeof(cb2PairKey));
+		memcpy(m_pairBuffer, oldBuffer, m_pairCount * sizeof(cb2PairKey));
+		cb2Free(oldBuffer);
+		cb2Free(m_pairScratch);
+		m_pairScratch = (cb2PairKey*)cb2Alloc(m_pairCapacity * sizeof(cb2PairKey));
+	}
+
+	cb2Assert(proxyIdA < proxyIdB);
+	m_pairBuffer[m_pairCount] = cb2MakePairKey(proxyIdA, proxyIdB);
+	++m_pairCount;
 }
 
 template <typename T>
@@ -188,48 +245,29 @@ void cb2BroadPhase::UpdatePairs(T* callback)
 	// Reset pair buffer
 	m_pairCount = 0;
 
-	// Perform tree queries for all moving proxies.
-	for (int i = 0; i < m_moveCount; ++i)
-	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
-		{
-			continue;
-		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const cb2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
-	}
+	// Let the backend gather the pairs of all moving proxies.
+	m_backend->FindPairs(this, m_moveBuffer, m_moveCount);
 
 	// Reset move buffer
 	m_moveCount = 0;
 
 	// Sort the pair buffer to expose duplicates.
-	std::sort(m_pairBuffer, m_pairBuffer + m_pairCount, cb2PairLessThan);
+	SortPairs();
 
 	// Send the pairs back to the client.
 	int i = 0;
 	while (i < m_pairCount)
 	{
-		cb2Pair* primaryPair = m_pairBuffer + i;
-		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
-		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
+		cb2PairKey primaryKey = m_pairBuffer[i];
+		void* userDataA = m_backend->GetUserData(int(primaryKey >> 32));
+		void* userDataB = m_backend->GetUserData(int(primaryKey & 0xffffffff));
 
 		callback->AddPair(userDataA, userDataB);
 		++i;
 
 		// Skip any duplicate pairs.
-		while (i < m_pairCount)
+		while (i < m_pairCount && m_pairBuffer[i] == primaryKey)
 		{
-			cb2Pair* pair = m_pairBuffer + i;
-			if (pair->proxyIdA != primaryPair->proxyIdA || pair->proxyIdB != primaryPair->proxyIdB)
-			{
-				break;
-			}
 			++i;
 		}
 	}
@@ -241,18 +279,38 @@ void cb2BroadPhase::UpdatePairs(T* callback)
 template <typename T>
 inline void cb2BroadPhase::Query(T* callback, const cb2AABB& aabb) const
 {
-	m_tree.Query(callback, aabb);
+	// Keep the default tree free of virtual calls.
+	if (m_backend == &m_treeBackend)
+	{
+		m_treeBackend.GetTree().Query(callback, aabb);
+		return;
+	}
+
+	cb2BroadPhaseQueryAdapter<T> adapter(callback);
+	m_backend->Query(&adapter, aabb);
 }
 
 template <typename T>
 inline void cb2BroadPhase::RayCast(T* callback, const cb2RayCastInput& input) const
 {
-	m_tree.RayCast(callback, input);
+	if (m_backend == &m_treeBackend)
+	{
+		m_treeBackend.GetTree().RayCast(callback, input);
+		return;
+	}
+
+	cb2BroadPhaseRayCastAdapter<T> adapter(callback);
+	m_backend->RayCast(&adapter, input);
 }
 
 inline void cb2BroadPhase::ShiftOrigin(const ci::Vec2f& newOrigin)
 {
-	m_tree.ShiftOrigin(newOrigin);
+	m_backend->ShiftOrigin(newOrigin);
+}
+
+inline void cb2BroadPhase::Maintain()
+{
+	m_backend->Maintain();
 }
 
 #endif
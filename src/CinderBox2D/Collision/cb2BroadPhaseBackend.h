@@ -0,0 +1,130 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef CB2_BROAD_PHASE_BACKEND_H
+#define CB2_BROAD_PHASE_BACKEND_H
+
+#include <CinderBox2D/Common/cb2Settings.h>
+#include <CinderBox2D/Collision/cb2Collision.h>
+
+class cb2BroadPhase;
+
+/// Callback used by broad-phase backends to report proxies for volume
+/// queries and ray casts. cb2BroadPhase adapts its template callbacks to this.
+class cb2BroadPhaseCallback
+{
+public:
+	virtual ~cb2BroadPhaseCallback() {}
+
+	/// Called for each proxy that overlaps the query AABB.
+	/// @return false to terminate the query.
+	virtual bool QueryCallback(int proxyId) { CB2_NOT_USED(proxyId); return true; }
+
+	/// Called for each proxy that may be hit by the ray.
+	/// @return 0 to terminate, the new max fraction to clip the ray, or
+	/// input.maxFraction to continue.
+	virtual float RayCastCallback(const cb2RayCastInput& input, int proxyId)
+	{
+		CB2_NOT_USED(proxyId);
+		return input.maxFraction;
+	}
+};
+
+/// The acceleration structure behind cb2BroadPhase. A backend stores the
+/// proxies with their fat AABBs and finds candidate pairs for proxies that
+/// moved. The broad-phase owns the move buffer and removes duplicate pairs,
+/// so a backend may report the same pair more than once.
+/// Implement this to plug a custom structure into the broad-phase.
+/// @see cb2World::SetBroadPhaseBackend
+class cb2BroadPhaseBackend
+{
+public:
+	virtual ~cb2BroadPhaseBackend() {}
+
+	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
+	virtual int CreateProxy(const cb2AABB& aabb, void* userData) = 0;
+
+	/// Destroy a proxy. This asserts if the id is invalid.
+	virtual void DestroyProxy(int proxyId) = 0;
+
+	/// Move a proxy with a swept AABB.
+	/// @return true if the fat AABB grew and the proxy needs a pair update.
+	virtual bool MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement) = 0;
+
+	/// Get proxy user data.
+	virtual void* GetUserData(int proxyId) const = 0;
+
+	/// Get the fat AABB for a proxy.
+	virtual const cb2AABB& GetFatAABB(int proxyId) const = 0;
+
+	/// Report the potential pairs of the moved proxies through cb2BroadPhase::BufferPair.
+	/// Entries of the move buffer may be cb2BroadPhase::e_nullProxy.
+	virtual void FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount) = 0;
+
+	/// Query an AABB for overlapping proxies.
+	virtual void Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const = 0;
+
+	/// Ray-cast against the proxies. The ray extends from p1 to p1 + maxFraction * (p2 - p1).
+	virtual void RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const = 0;
+
+	/// Shift the world origin.
+	virtual void ShiftOrigin(const ci::Vec2f& newOrigin) = 0;
+
+	/// Called once per time step after the proxies moved. Backends may use this
+	/// to restore the quality of their structure.
+	virtual void Maintain() {}
+
+	/// Tree statistics. Backends without a tree report zero.
+	virtual int GetHeight() const { return 0; }
+	virtual int GetMaxBalance() const { return 0; }
+	virtual float GetAreaRatio() const { return 0.0f; }
+
+protected:
+
+	/// Extend an AABB by cb2_aabbExtension and predict the displacement,
+	/// the same way cb2DynamicTree fattens its leaves.
+	static void ComputeFatAABB(cb2AABB* fatAABB, const cb2AABB& aabb, const ci::Vec2f& displacement)
+	{
+		ci::Vec2f r(cb2_aabbExtension, cb2_aabbExtension);
+		fatAABB->lowerBound = aabb.lowerBound - r;
+		fatAABB->upperBound = aabb.upperBound + r;
+
+		ci::Vec2f d = cb2_aabbMultiplier * displacement;
+
+		if (d.x < 0.0f)
+		{
+			fatAABB->lowerBound.x += d.x;
+		}
+		else
+		{
+			fatAABB->upperBound.x += d.x;
+		}
+
+		if (d.y < 0.0f)
+		{
+			fatAABB->lowerBound.y += d.y;
+		}
+		else
+		{
+			fatAABB->upperBound.y += d.y;
+		}
+	}
+};
+
+#endif
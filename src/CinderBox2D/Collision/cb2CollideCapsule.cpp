@@ -0,0 +1,255 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <CinderBox2D/Collision/cb2Collision.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CircleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+
+// A capsule is a two sided polygon with the capsule radius.
+static void cb2MakeCapsulePolygon(cb2PolygonShape* polygon, const cb2CapsuleShape* capsule)
+{
+	ci::Vec2f normal = cb2Cross(capsule->m_vertex2 - capsule->m_vertex1, 1.0f);
+	normal.normalize();
+
+	polygon->m_count = 2;
+	polygon->m_vertices[0] = capsule->m_vertex1;
+	polygon->m_vertices[1] = capsule->m_vertex2;
+	polygon->m_normals[0] = normal;
+	polygon->m_normals[1] = -normal;
+	polygon->m_centroid = 0.5f * (capsule->m_vertex1 + capsule->m_vertex2);
+	polygon->m_radius = capsule->m_radius;
+}
+
+void cb2CollideCapsuleAndCircle(cb2Manifold* manifold,
+								const cb2CapsuleShape* capsuleA, const cb2Transform& xfA,
+								const cb2CircleShape* circleB, const cb2Transform& xfB,
+								float margin)
+{
+	manifold->pointCount = 0;
+
+	// Compute circle in frame of capsule
+	ci::Vec2f Q = cb2MulT(xfA, cb2Mul(xfB, circleB->m_p));
+
+	ci::Vec2f A = capsuleA->m_vertex1, B = capsuleA->m_vertex2;
+	ci::Vec2f e = B - A;
+	float s = cb2Clamp(cb2Dot(Q - A, e) / cb2Dot(e, e), 0.0f, 1.0f);
+	ci::Vec2f P = A + s * e;
+
+	float radius = capsuleA->m_radius + circleB->m_radius + margin;
+	if (cb2DistanceSquared(Q, P) > radius * radius)
+	{
+		return;
+	}
+
+	cb2ContactFeature cf;
+	cf.indexB = 0;
+	cf.typeB = cb2ContactFeature::e_vertex;
+
+	manifold->pointCount = 1;
+	manifold->points[0].id.key = 0;
+	manifold->points[0].localPoint = circleB->m_p;
+
+	// Regions A and B
+	if (s == 0.0f || s == 1.0f)
+	{
+		cf.indexA = s == 0.0f ? 0 : 1;
+		cf.typeA = cb2ContactFeature::e_vertex;
+		manifold->type = cb2Manifold::e_circles;
+		cb2::setZero(manifold->localNormal);
+		manifold->localPoint = P;
+		manifold->points[0].id.cf = cf;
+		return;
+	}
+
+	// Region AB
+	ci::Vec2f n(-e.y, e.x);
+	if (cb2Dot(n, Q - A) < 0.0f)
+	{
+		n = -n;
+	}
+	n.normalize();
+
+	cf.indexA = 0;
+	cf.typeA = cb2ContactFeature::e_face;
+	manifold->type = cb2Manifold::e_faceA;
+	manifold->localNormal = n;
+	manifold->localPoint = A;
+	manifold->points[0].id.cf = cf;
+}
+
+// Collide segment p1-q1 of shape A, rounded by radiusA, with capsule B. This
+// also returns the closest point on the capsule segment in the frame of A and
+// its fraction along segment A.
+static void cb2CollideSegmentAndCapsule(cb2Manifold* manifold, ci::Vec2f* closestB, float* fractionA,
+										const ci::Vec2f& p1, const ci::Vec2f& q1, float radiusA, const cb2Transform& xfA,
+										const cb2CapsuleShape* capsuleB, const cb2Transform& xfB, float margin)
+{
+	manifold->pointCount = 0;
+
+	// Compute capsule B in frame of A
+	cb2Transform xf = cb2MulT(xfA, xfB);
+	ci::Vec2f p2 = cb2Mul(xf, capsuleB->m_vertex1), q2 = cb2Mul(xf, capsuleB->m_vertex2);
+
+	float s, t;
+	cb2ClosestSegmentPoints(&s, &t, p1, q1, p2, q2);
+	ci::Vec2f d1 = q1 - p1, d2 = q2 - p2;
+	ci::Vec2f cA = p1 + s * d1;
+	ci::Vec2f cB = p2 + t * d2;
+	*closestB = cB;
+	*fractionA = s;
+
+	float radius = radiusA + capsuleB->m_radius + margin;
+	float distanceSqr = cb2DistanceSquared(cA, cB);
+	if (distanceSqr > radius * radius)
+	{
+		return;
+	}
+
+	// The normal of A pointing to B.
+	float length1 = d1.length();
+	float length2 = d2.length();
+	ci::Vec2f axis = d1 / length1;
+	ci::Vec2f normal(axis.y, -axis.x);
+	ci::Vec2f toB = distanceSqr > cb2_epsilon * cb2_epsilon ? cB - cA : 0.5f * (p2 + q2) - p1;
+	if (cb2Dot(normal, toB) < 0.0f)
+	{
+		normal = -normal;
+	}
+
+	// Nearly parallel capsules overlapping along A rest on two points. Clip B to
+	// the extent of A and keep the ends within the radius.
+	const float k_parallelTolerance = 0.1f;
+	if (cb2Abs(cb2Cross(d1, d2)) < k_parallelTolerance * length1 * length2)
+	{
+		float u2 = cb2Dot(p2 - p1, axis);
+		float v2 = cb2Dot(q2 - p1, axis);
+		float lower = cb2Max(cb2Min(u2, v2), 0.0f);
+		float upper = cb2Min(cb2Max(u2, v2), length1);
+
+		if (upper - lower > cb2_linearSlop)
+		{
+			float bounds[2] = { lower, upper };
+			for (int i = 0; i < 2; ++i)
+			{
+				float tB = (bounds[i] - u2) / (v2 - u2);
+				ci::Vec2f pB = p2 + tB * d2;
+				if (cb2Dot(normal, pB - p1) > radius)
+				{
+					continue;
+				}
+
+				cb2ManifoldPoint* mp = manifold->points + manifold->pointCount;
+				mp->localPoint = capsuleB->m_vertex1 + tB * (capsuleB->m_vertex2 - capsuleB->m_vertex1);
+				mp->id.cf.indexA = 0;
+				mp->id.cf.indexB = (unsigned char)i;
+				mp->id.cf.typeA = cb2ContactFeature::e_face;
+				mp->id.cf.typeB = cb2ContactFeature::e_vertex;
+				++manifold->pointCount;
+			}
+
+			if (manifold->pointCount > 0)
+			{
+				manifold->type = cb2Manifold::e_faceA;
+				manifold->localNormal = normal;
+				manifold->localPoint = 0.5f * (p1 + q1);
+				return;
+			}
+		}
+	}
+
+	// A single point between the closest points. Crossing segments use the
+	// normal of A since the closest points coincide.
+	manifold->pointCount = 1;
+	manifold->points[0].localPoint = capsuleB->m_vertex1 + t * (capsuleB->m_vertex2 - capsuleB->m_vertex1);
+	manifold->points[0].id.key = 0;
+
+	if (distanceSqr > cb2_epsilon * cb2_epsilon)
+	{
+		manifold->type = cb2Manifold::e_circles;
+		manifold->localPoint = cA;
+		cb2::setZero(manifold->localNormal);
+	}
+	else
+	{
+		manifold->type = cb2Manifold::e_faceA;
+		manifold->localPoint = cA;
+		manifold->localNormal = normal;
+	}
+}
+
+void cb2CollideCapsules(cb2Manifold* manifold,
+						const cb2CapsuleShape* capsuleA, const cb2Transform& xfA,
+						const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+						float margin)
+{
+	ci::Vec2f closestB;
+	float fractionA;
+	cb2CollideSegmentAndCapsule(manifold, &closestB, &fractionA,
+								capsuleA->m_vertex1, capsuleA->m_vertex2, capsuleA->m_radius, xfA, capsuleB, xfB, margin);
+}
+
+void cb2CollidePolygonAndCapsule(cb2Manifold* manifold,
+								 const cb2PolygonShape* polygonA, const cb2Transform& xfA,
+								 const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+								 cb2PolygonCache* cache, float margin)
+{
+	cb2PolygonShape polygonB;
+	cb2MakeCapsulePolygon(&polygonB, capsuleB);
+	cb2CollidePolygons(manifold, polygonA, xfA, &polygonB, xfB, cache, margin);
+}
+
+// Compute contact points for edge versus capsule.
+// This accounts for edge connectivity as cb2CollideEdgeAndCircle does.
+void cb2CollideEdgeAndCapsule(cb2Manifold* manifold,
+							  const cb2EdgeShape* edgeA, const cb2Transform& xfA,
+							  const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+							  float margin)
+{
+	ci::Vec2f A = edgeA->m_vertex1, B = edgeA->m_vertex2;
+	ci::Vec2f Q;
+	float s;
+	cb2CollideSegmentAndCapsule(manifold, &Q, &s, A, B, edgeA->m_radius, xfA, capsuleB, xfB, margin);
+
+	if (manifold->pointCount != 1 || manifold->type != cb2Manifold::e_circles)
+	{
+		return;
+	}
+
+	// Region A: is the capsule in Region AB of the previous edge?
+	if (s == 0.0f && edgeA->m_hasVertex0)
+	{
+		ci::Vec2f e1 = A - edgeA->m_vertex0;
+		if (cb2Dot(e1, A - Q) > 0.0f)
+		{
+			manifold->pointCount = 0;
+		}
+	}
+
+	// Region B: is the capsule in Region AB of the next edge?
+	if (s == 1.0f && edgeA->m_hasVertex3)
+	{
+		ci::Vec2f e2 = edgeA->m_vertex3 - B;
+		if (cb2Dot(e2, Q - B) > 0.0f)
+		{
+			manifold->pointCount = 0;
+		}
+	}
+}
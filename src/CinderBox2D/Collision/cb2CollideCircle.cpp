@@ -23,7 +23,8 @@
 void cb2CollideCircles(
 	cb2Manifold* manifold,
 	const cb2CircleShape* circleA, const cb2Transform& xfA,
-	const cb2CircleShape* circleB, const cb2Transform& xfB)
+	const cb2CircleShape* circleB, const cb2Transform& xfB,
+	float margin)
 {
 	manifold->pointCount = 0;
 
@@ -33,7 +34,7 @@ void cb2CollideCircles(
 	ci::Vec2f d = pB - pA;
 	float distSqr = cb2Dot(d, d);
 	float rA = circleA->m_radius, rB = circleB->m_radius;
-	float radius = rA + rB;
+	float radius = rA + rB + margin;
 	if (distSqr > radius * radius)
 	{
 		return;
@@ -51,7 +52,8 @@ void cb2CollideCircles(
 void cb2CollidePolygonAndCircle(
 	cb2Manifold* manifold,
 	const cb2PolygonShape* polygonA, const cb2Transform& xfA,
-	const cb2CircleShape* circleB, const cb2Transform& xfB)
+	const cb2CircleShape* circleB, const cb2Transform& xfB,
+	float margin)
 {
 	manifold->pointCount = 0;
 
@@ -62,7 +64,7 @@ void cb2CollidePolygonAndCircle(
 	// Find the min separating edge.
 	int normalIndex = 0;
 	float separation = -cb2_maxFloat;
-	float radius = polygonA->m_radius + circleB->m_radius;
+	float radius = polygonA->m_radius + circleB->m_radius + margin;
 	int vertexCount = polygonA->m_count;
 	const ci::Vec2f* vertices = polygonA->m_vertices;
 	const ci::Vec2f* normals = polygonA->m_normals;
@@ -26,7 +26,8 @@
 // This accounts for edge connectivity.
 void cb2CollideEdgeAndCircle(cb2Manifold* manifold,
 							const cb2EdgeShape* edgeA, const cb2Transform& xfA,
-							const cb2CircleShape* circleB, const cb2Transform& xfB)
+							const cb2CircleShape* circleB, const cb2Transform& xfB,
+							float margin)
 {
 	manifold->pointCount = 0;
 	
@@ -40,7 +41,7 @@ void cb2CollideEdgeAndCircle(cb2Manifold* manifold,
 	float u = cb2Dot(e, B - Q);
 	float v = cb2Dot(e, Q - A);
 	
-	float radius = edgeA->m_radius + circleB->m_radius;
+	float radius = edgeA->m_radius + circleB->m_radius + margin;
 	
 	cb2ContactFeature cf;
 	cf.indexB = 0;
@@ -194,7 +195,7 @@ struct cb2ReferenceFace
 struct cb2EPCollider
 {
 	void Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, const cb2Transform& xfA,
-				 const cb2PolygonShape* polygonB, const cb2Transform& xfB);
+				 const cb2PolygonShape* polygonB, const cb2Transform& xfB, float margin);
 	cb2EPAxis ComputeEdgeSeparation();
 	cb2EPAxis ComputePolygonSeparation();
 	
@@ -215,6 +216,7 @@ struct cb2EPCollider
 	VertexType m_type1, m_type2;
 	ci::Vec2f m_lowerLimit, m_upperLimit;
 	float m_radius;
+	float m_maxSeparation;
 	bool m_front;
 };
 
@@ -228,7 +230,7 @@ struct cb2EPCollider
 // 7. Return if _any_ axis indicates separation
 // 8. Clip
 void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, const cb2Transform& xfA,
-						   const cb2PolygonShape* polygonB, const cb2Transform& xfB)
+						   const cb2PolygonShape* polygonB, const cb2Transform& xfB, float margin)
 {
 	m_xf = cb2MulT(xfA, xfB);
 	
@@ -432,7 +434,8 @@ void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, co
 		m_polygonB.normals[i] = cb2Mul(m_xf.q, polygonB->m_normals[i]);
 	}
 	
-	m_radius = 2.0f * cb2_polygonRadius;
+	m_radius = edgeA->m_radius + polygonB->m_radius;
+	m_maxSeparation = m_radius + margin;
 	
 	manifold->pointCount = 0;
 	
@@ -444,13 +447,13 @@ void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, co
 		return;
 	}
 	
-	if (edgeAxis.separation > m_radius)
+	if (edgeAxis.separation > m_maxSeparation)
 	{
 		return;
 	}
 	
 	cb2EPAxis polygonAxis = ComputePolygonSeparation();
-	if (polygonAxis.type != cb2EPAxis::e_unknown && polygonAxis.separation > m_radius)
+	if (polygonAxis.type != cb2EPAxis::e_unknown && polygonAxis.separation > m_maxSeparation)
 	{
 		return;
 	}
@@ -551,6 +554,11 @@ void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, co
 	rf.sideNormal2 = -rf.sideNormal1;
 	rf.sideOffset1 = cb2Dot(rf.sideNormal1, rf.v1);
 	rf.sideOffset2 = cb2Dot(rf.sideNormal2, rf.v2);
+
+	// Extend the sides by the rounding so rounded corners can touch.
+	float rounding = cb2Max(m_radius - 2.0f * cb2_polygonRadius, 0.0f);
+	rf.sideOffset1 += rounding;
+	rf.sideOffset2 += rounding;
 	
 	// Clip incident edge against extruded edge1 side edges.
 	cb2ClipVertex clipPoints1[2];
@@ -592,7 +600,7 @@ void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, co
 		
 		separation = cb2Dot(rf.normal, clipPoints2[i].v - rf.v1);
 		
-		if (separation <= m_radius)
+		if (separation <= m_maxSeparation)
 		{
 			cb2ManifoldPoint* cp = manifold->points + pointCount;
 			
@@ -615,6 +623,13 @@ void cb2EPCollider::Collide(cb2Manifold* manifold, const cb2EdgeShape* edgeA, co
 	}
 	
 	manifold->pointCount = pointCount;
+
+	// Rounding beyond the skins needs the corners checked.
+	if (m_radius - 2.0f * cb2_polygonRadius > cb2_linearSlop)
+	{
+		cb2RoundManifold(manifold, &edgeA->m_vertex1, NULL, 2, edgeA->m_radius, xfA,
+						 polygonB->m_vertices, polygonB->m_normals, polygonB->m_count, polygonB->m_radius, xfB, margin);
+	}
 }
 
 cb2EPAxis cb2EPCollider::ComputeEdgeSeparation()
@@ -653,7 +668,7 @@ cb2EPAxis cb2EPCollider::ComputePolygonSeparation()
 		float s2 = cb2Dot(n, m_polygonB.vertices[i] - m_v2);
 		float s = cb2Min(s1, s2);
 		
-		if (s > m_radius)
+		if (s > m_maxSeparation)
 		{
 			// No collision
 			axis.type = cb2EPAxis::e_edgeB;
@@ -691,8 +706,9 @@ cb2EPAxis cb2EPCollider::ComputePolygonSeparation()
 
 void cb2CollideEdgeAndPolygon(	cb2Manifold* manifold,
 							 const cb2EdgeShape* edgeA, const cb2Transform& xfA,
-							 const cb2PolygonShape* polygonB, const cb2Transform& xfB)
+							 const cb2PolygonShape* polygonB, const cb2Transform& xfB,
+							 float margin)
 {
 	cb2EPCollider collider;
-	collider.Collide(manifold, edgeA, xfA, polygonB, xfB);
+	collider.Collide(manifold, edgeA, xfA, polygonB, xfB, margin);
 }
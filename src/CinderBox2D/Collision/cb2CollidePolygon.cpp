@@ -20,7 +20,8 @@
 #include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
 
 // Find the max separation between poly1 and poly2 using edge normals from poly1.
-static float cb2FindMaxSeparation(int* edgeIndex,
+// Also returns the deepest vertex of poly2 along the best normal.
+static float cb2FindMaxSeparation(int* edgeIndex, int* vertexIndex,
 								 const cb2PolygonShape* poly1, const cb2Transform& xf1,
 								 const cb2PolygonShape* poly2, const cb2Transform& xf2)
 {
@@ -32,6 +33,7 @@ static float cb2FindMaxSeparation(int* edgeIndex,
 	cb2Transform xf = cb2MulT(xf2, xf1);
 
 	int bestIndex = 0;
+	int bestVertex = 0;
 	float maxSeparation = -cb2_maxFloat;
 	for (int i = 0; i < count1; ++i)
 	{
@@ -41,26 +43,137 @@ static float cb2FindMaxSeparation(int* edgeIndex,
 
 		// Find deepest point for normal i.
 		float si = cb2_maxFloat;
+		int vi = 0;
 		for (int j = 0; j < count2; ++j)
 		{
 			float sij = cb2Dot(n, v2s[j] - v1);
 			if (sij < si)
-	{
+			{
 				si = sij;
-	}
-	}
+				vi = j;
+			}
+		}
 
 		if (si > maxSeparation)
 		{
 			maxSeparation = si;
 			bestIndex = i;
+			bestVertex = vi;
 		}
 	}
 
 	*edgeIndex = bestIndex;
+	*vertexIndex = bestVertex;
 	return maxSeparation;
 }
 
+// Find the separation of poly2 along the normal of one poly1 edge by walking from a
+// seed vertex to the deepest vertex of poly2. The vertex projections of a convex
+// polygon are unimodal, so the walk ends at the same depth as a full scan.
+// Every visited vertex bounds the separation from above, so the walk may stop
+// once it reaches the floor. The transform xf maps frame 1 into frame 2.
+static float cb2WalkSeparation(int* vertexIndex, const cb2PolygonShape* poly1, const cb2Transform& xf, int edge,
+							  const cb2PolygonShape* poly2, float floor)
+{
+	int count2 = poly2->m_count;
+	const ci::Vec2f* v2s = poly2->m_vertices;
+
+	ci::Vec2f n = cb2Mul(xf.q, poly1->m_normals[edge]);
+	ci::Vec2f v1 = cb2Mul(xf, poly1->m_vertices[edge]);
+
+	int index = *vertexIndex;
+	float separation = cb2Dot(n, v2s[index] - v1);
+	if (separation <= floor)
+	{
+		return separation;
+	}
+
+	// Walk forward, or backward if forward does not descend.
+	int step = 1;
+	int next = index + 1 < count2 ? index + 1 : 0;
+	float s = cb2Dot(n, v2s[next] - v1);
+	if (s >= separation)
+	{
+		step = count2 - 1;
+		next = index > 0 ? index - 1 : count2 - 1;
+		s = cb2Dot(n, v2s[next] - v1);
+	}
+
+	while (s < separation)
+	{
+		separation = s;
+		index = next;
+		if (separation <= floor)
+		{
+			break;
+		}
+
+		next = (index + step) % count2;
+		s = cb2Dot(n, v2s[next] - v1);
+	}
+
+	*vertexIndex = index;
+	return separation;
+}
+
+// Check that a cached edge still has the max separation. A cached separating axis
+// needs no further check. Returns false if the full search is needed.
+static bool cb2VerifyMaxSeparation(float* separation, int edge, int* vertexIndex,
+								  const cb2PolygonShape* poly1, const cb2Transform& xf1,
+								  const cb2PolygonShape* poly2, const cb2Transform& xf2,
+								  float maxSeparation)
+{
+	int count1 = poly1->m_count;
+	if (edge >= count1 || *vertexIndex >= poly2->m_count)
+	{
+		return false;
+	}
+
+	cb2Transform xf = cb2MulT(xf2, xf1);
+	float s = cb2WalkSeparation(vertexIndex, poly1, xf, edge, poly2, -cb2_maxFloat);
+	*separation = s;
+
+	if (s > maxSeparation)
+	{
+		return true;
+	}
+
+	// Every other edge only needs to be shown no deeper, so checking them all keeps
+	// the result equal to the full search even when the polygons overlap deeply.
+	// Starting at the deepest vertex of the cached edge this usually takes a single
+	// projection per edge.
+	for (int i = 0; i < count1; ++i)
+	{
+		if (i == edge)
+		{
+			continue;
+		}
+
+		int vertex = *vertexIndex;
+		if (cb2WalkSeparation(&vertex, poly1, xf, i, poly2, s) > s)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Find the max separation, trying the cached edge first.
+static float cb2FindCachedMaxSeparation(int* edgeIndex, int* vertexIndex, bool cached,
+									   const cb2PolygonShape* poly1, const cb2Transform& xf1,
+									   const cb2PolygonShape* poly2, const cb2Transform& xf2,
+									   float maxSeparation)
+{
+	float separation;
+	if (cached && cb2VerifyMaxSeparation(&separation, *edgeIndex, vertexIndex, poly1, xf1, poly2, xf2, maxSeparation))
+	{
+		return separation;
+	}
+
+	return cb2FindMaxSeparation(edgeIndex, vertexIndex, poly1, xf1, poly2, xf2);
+}
+
 static void cb2FindIncidentEdge(cb2ClipVertex c[2],
 							 const cb2PolygonShape* poly1, const cb2Transform& xf1, int edge1,
 							 const cb2PolygonShape* poly2, const cb2Transform& xf2)
@@ -115,21 +228,34 @@ static void cb2FindIncidentEdge(cb2ClipVertex c[2],
 // The normal points from 1 to 2
 void cb2CollidePolygons(cb2Manifold* manifold,
 					  const cb2PolygonShape* polyA, const cb2Transform& xfA,
-					  const cb2PolygonShape* polyB, const cb2Transform& xfB)
+					  const cb2PolygonShape* polyB, const cb2Transform& xfB,
+					  cb2PolygonCache* cache, float margin)
 {
 	manifold->pointCount = 0;
 	float totalRadius = polyA->m_radius + polyB->m_radius;
+	float maxSeparation = totalRadius + margin;
 
-	int edgeA = 0;
-	float separationA = cb2FindMaxSeparation(&edgeA, polyA, xfA, polyB, xfB);
-	if (separationA > totalRadius)
+	// Without a cache every search starts from scratch.
+	cb2PolygonCache scratch;
+	bool cached = cache != NULL;
+	if (cached == false)
+	{
+		cache = &scratch;
+	}
+
+	float separationA = cb2FindCachedMaxSeparation(&cache->edgeA, &cache->vertexB, cached,
+												  polyA, xfA, polyB, xfB, maxSeparation);
+	if (separationA > maxSeparation)
 		return;
 
-	int edgeB = 0;
-	float separationB = cb2FindMaxSeparation(&edgeB, polyB, xfB, polyA, xfA);
-	if (separationB > totalRadius)
+	float separationB = cb2FindCachedMaxSeparation(&cache->edgeB, &cache->vertexA, cached,
+												  polyB, xfB, polyA, xfA, maxSeparation);
+	if (separationB > maxSeparation)
 		return;
 
+	int edgeA = cache->edgeA;
+	int edgeB = cache->edgeB;
+
 	const cb2PolygonShape* poly1;	// reference polygon
 	const cb2PolygonShape* poly2;	// incident polygon
 	cb2Transform xf1, xf2;
@@ -217,7 +343,7 @@ void cb2CollidePolygons(cb2Manifold* manifold,
 	{
 		float separation = cb2Dot(normal, clipPoints2[i].v) - frontOffset;
 
-		if (separation <= totalRadius)
+		if (separation <= maxSeparation)
 		{
 			cb2ManifoldPoint* cp = manifold->points + pointCount;
 			cp->localPoint = cb2MulT(xf2, clipPoints2[i].v);
@@ -236,4 +362,11 @@ void cb2CollidePolygons(cb2Manifold* manifold,
 	}
 
 	manifold->pointCount = pointCount;
+
+	// Rounding beyond the skins needs the corners checked.
+	if (totalRadius - 2.0f * cb2_polygonRadius > cb2_linearSlop)
+	{
+		cb2RoundManifold(manifold, polyA->m_vertices, polyA->m_normals, polyA->m_count, polyA->m_radius, xfA,
+						 polyB->m_vertices, polyB->m_normals, polyB->m_count, polyB->m_radius, xfB, margin);
+	}
 }
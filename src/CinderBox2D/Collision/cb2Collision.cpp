@@ -230,9 +230,189 @@ int cb2ClipSegmentToLine(cb2ClipVertex vOut[2], const cb2ClipVertex vIn[2],
 	return numOut;
 }
 
+// Real-Time Collision Detection by Christer Ericson, Section 5.1.9
+void cb2ClosestSegmentPoints(float* s, float* t,
+							 const ci::Vec2f& p1, const ci::Vec2f& q1,
+							 const ci::Vec2f& p2, const ci::Vec2f& q2)
+{
+	ci::Vec2f d1 = q1 - p1;
+	ci::Vec2f d2 = q2 - p2;
+	ci::Vec2f r = p1 - p2;
+	float a = cb2Dot(d1, d1);
+	float e = cb2Dot(d2, d2);
+	float f = cb2Dot(d2, r);
+
+	if (a <= cb2_epsilon && e <= cb2_epsilon)
+	{
+		*s = 0.0f;
+		*t = 0.0f;
+		return;
+	}
+
+	if (a <= cb2_epsilon)
+	{
+		*s = 0.0f;
+		*t = cb2Clamp(f / e, 0.0f, 1.0f);
+		return;
+	}
+
+	float c = cb2Dot(d1, r);
+	if (e <= cb2_epsilon)
+	{
+		*t = 0.0f;
+		*s = cb2Clamp(-c / a, 0.0f, 1.0f);
+		return;
+	}
+
+	float b = cb2Dot(d1, d2);
+	float denom = a * e - b * b;
+
+	// Parallel segments pick an arbitrary s.
+	*s = denom != 0.0f ? cb2Clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+	*t = (b * *s + f) / e;
+
+	if (*t < 0.0f)
+	{
+		*t = 0.0f;
+		*s = cb2Clamp(-c / a, 0.0f, 1.0f);
+	}
+	else if (*t > 1.0f)
+	{
+		*t = 1.0f;
+		*s = cb2Clamp((b - c) / a, 0.0f, 1.0f);
+	}
+}
+
+// The polygon routines treat the rounding of a shape as if it were square, so
+// near the corners they report contact while the rounded shapes are still
+// apart. When the cores are apart, check their closest points: beyond the
+// radius there is no contact, and if they are not along the manifold normal
+// the closest features are corners and a single point replaces the manifold.
+void cb2RoundManifold(cb2Manifold* manifold,
+					  const ci::Vec2f* verticesA, const ci::Vec2f* normalsA, int countA,
+					  float radiusA, const cb2Transform& xfA,
+					  const ci::Vec2f* verticesB, const ci::Vec2f* normalsB, int countB,
+					  float radiusB, const cb2Transform& xfB, float margin)
+{
+	if (manifold->pointCount == 0 || manifold->type == cb2Manifold::e_circles)
+	{
+		return;
+	}
+
+	cb2Assert(countB <= cb2_maxPolygonVertices);
+
+	// Work in the frame of A.
+	cb2Transform xf = cb2MulT(xfA, xfB);
+	ci::Vec2f vertices[cb2_maxPolygonVertices];
+	for (int i = 0; i < countB; ++i)
+	{
+		vertices[i] = cb2Mul(xf, verticesB[i]);
+	}
+
+	// Does one core contain the other?
+	if (normalsA != NULL)
+	{
+		bool inside = true;
+		for (int i = 0; i < countA && inside; ++i)
+		{
+			inside = cb2Dot(normalsA[i], vertices[0] - verticesA[i]) < 0.0f;
+		}
+
+		if (inside)
+		{
+			return;
+		}
+	}
+
+	if (normalsB != NULL)
+	{
+		ci::Vec2f p = cb2MulT(xf, verticesA[0]);
+		bool inside = true;
+		for (int i = 0; i < countB && inside; ++i)
+		{
+			inside = cb2Dot(normalsB[i], p - verticesB[i]) < 0.0f;
+		}
+
+		if (inside)
+		{
+			return;
+		}
+	}
+
+	// Closest points between the edges of the cores. A segment has one edge.
+	int edgeCountA = countA == 2 ? 1 : countA;
+	int edgeCountB = countB == 2 ? 1 : countB;
+	float bestDistanceSqr = cb2_maxFloat;
+	int bestA = 0, bestB = 0;
+	ci::Vec2f bestPointA, bestPointB;
+	for (int i = 0; i < edgeCountA; ++i)
+	{
+		const ci::Vec2f& a1 = verticesA[i];
+		const ci::Vec2f& a2 = verticesA[i + 1 < countA ? i + 1 : 0];
+
+		for (int j = 0; j < edgeCountB; ++j)
+		{
+			const ci::Vec2f& b1 = vertices[j];
+			const ci::Vec2f& b2 = vertices[j + 1 < countB ? j + 1 : 0];
+
+			float s, t;
+			cb2ClosestSegmentPoints(&s, &t, a1, a2, b1, b2);
+			ci::Vec2f pA = a1 + s * (a2 - a1);
+			ci::Vec2f pB = b1 + t * (b2 - b1);
+			float distanceSqr = cb2DistanceSquared(pA, pB);
+			if (distanceSqr < bestDistanceSqr)
+			{
+				bestDistanceSqr = distanceSqr;
+				bestA = i;
+				bestB = j;
+				bestPointA = pA;
+				bestPointB = pB;
+			}
+		}
+	}
+
+	// Touching or overlapping cores are handled by the polygon routines.
+	if (bestDistanceSqr < cb2_linearSlop * cb2_linearSlop)
+	{
+		return;
+	}
+
+	float radius = radiusA + radiusB + margin;
+	if (bestDistanceSqr > radius * radius)
+	{
+		manifold->pointCount = 0;
+		return;
+	}
+
+	ci::Vec2f d = bestPointB - bestPointA;
+	d.normalize();
+
+	ci::Vec2f normal = manifold->localNormal;
+	if (manifold->type == cb2Manifold::e_faceB)
+	{
+		normal = -cb2Mul(xf.q, normal);
+	}
+
+	if (cb2Dot(d, normal) >= cosf(cb2_angularSlop))
+	{
+		return;
+	}
+
+	manifold->type = cb2Manifold::e_circles;
+	manifold->localPoint = bestPointA;
+	cb2::setZero(manifold->localNormal);
+	manifold->pointCount = 1;
+	manifold->points[0].localPoint = cb2MulT(xf, bestPointB);
+	manifold->points[0].id.cf.indexA = (unsigned char)bestA;
+	manifold->points[0].id.cf.indexB = (unsigned char)bestB;
+	manifold->points[0].id.cf.typeA = cb2ContactFeature::e_vertex;
+	manifold->points[0].id.cf.typeB = cb2ContactFeature::e_vertex;
+}
+
 bool cb2TestOverlap(	const cb2Shape* shapeA, int indexA,
 					const cb2Shape* shapeB, int indexB,
-					const cb2Transform& xfA, const cb2Transform& xfB)
+					const cb2Transform& xfA, const cb2Transform& xfB,
+					cb2SimplexCache* cache)
 {
 	cb2DistanceInput input;
 	input.proxyA.set(shapeA, indexA);
@@ -241,12 +421,16 @@ bool cb2TestOverlap(	const cb2Shape* shapeA, int indexA,
 	input.transformB = xfB;
 	input.useRadii = true;
 
-	cb2SimplexCache cache;
-	cache.count = 0;
+	cb2SimplexCache localCache;
+	if (cache == NULL)
+	{
+		localCache.count = 0;
+		cache = &localCache;
+	}
 
 	cb2DistanceOutput output;
 
-	cb2Distance(&output, &cache, &input);
+	cb2Distance(&output, cache, &input);
 
 	return output.distance < 10.0f * cb2_epsilon;
 }
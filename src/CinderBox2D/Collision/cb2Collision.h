@@ -27,9 +27,11 @@
 /// queries, and TOI queries.
 
 class cb2Shape;
+class cb2CapsuleShape;
 class cb2CircleShape;
 class cb2EdgeShape;
 class cb2PolygonShape;
+struct cb2SimplexCache;
 
 const unsigned char cb2_nullFeature = UCHAR_MAX;
 
@@ -143,6 +145,16 @@ struct cb2ClipVertex
 	cb2ContactID id;
 };
 
+/// The deepest edges of two polygons, kept between calls to cb2CollidePolygons.
+/// Zero initialize this before the first call.
+struct cb2PolygonCache
+{
+	int edgeA;		///< the edge of polygon A with the largest separation
+	int edgeB;		///< the edge of polygon B with the largest separation
+	int vertexA;	///< the deepest vertex of polygon A along the normal of edgeB
+	int vertexB;	///< the deepest vertex of polygon B along the normal of edgeA
+};
+
 /// Ray-cast input data. The ray extends from p1 to p1 + maxFraction * (p2 - p1).
 struct cb2RayCastInput
 {
@@ -215,39 +227,94 @@ struct cb2AABB
 	ci::Vec2f upperBound;	///< the upper vertex
 };
 
+/// The collision routines keep manifold points whose shapes are separated by up
+/// to margin. The solver uses these speculative points to stop approaching bodies
+/// before they overlap. @see cb2World::SetSpeculativeContacts
+
 /// Compute the collision manifold between two circles.
 void cb2CollideCircles(cb2Manifold* manifold,
 					  const cb2CircleShape* circleA, const cb2Transform& xfA,
-					  const cb2CircleShape* circleB, const cb2Transform& xfB);
+					  const cb2CircleShape* circleB, const cb2Transform& xfB,
+					  float margin = 0.0f);
 
 /// Compute the collision manifold between a polygon and a circle.
 void cb2CollidePolygonAndCircle(cb2Manifold* manifold,
 							   const cb2PolygonShape* polygonA, const cb2Transform& xfA,
-							   const cb2CircleShape* circleB, const cb2Transform& xfB);
+							   const cb2CircleShape* circleB, const cb2Transform& xfB,
+							   float margin = 0.0f);
 
-/// Compute the collision manifold between two polygons.
+/// Compute the collision manifold between two polygons. With a cache the last
+/// deepest edges are verified first and the full search only runs when they
+/// stop being the best.
 void cb2CollidePolygons(cb2Manifold* manifold,
 					   const cb2PolygonShape* polygonA, const cb2Transform& xfA,
-					   const cb2PolygonShape* polygonB, const cb2Transform& xfB);
+					   const cb2PolygonShape* polygonB, const cb2Transform& xfB,
+					   cb2PolygonCache* cache = NULL, float margin = 0.0f);
 
 /// Compute the collision manifold between an edge and a circle.
 void cb2CollideEdgeAndCircle(cb2Manifold* manifold,
 							   const cb2EdgeShape* polygonA, const cb2Transform& xfA,
-							   const cb2CircleShape* circleB, const cb2Transform& xfB);
+							   const cb2CircleShape* circleB, const cb2Transform& xfB,
+							   float margin = 0.0f);
 
 /// Compute the collision manifold between an edge and a circle.
 void cb2CollideEdgeAndPolygon(cb2Manifold* manifold,
 							   const cb2EdgeShape* edgeA, const cb2Transform& xfA,
-							   const cb2PolygonShape* circleB, const cb2Transform& xfB);
+							   const cb2PolygonShape* circleB, const cb2Transform& xfB,
+							   float margin = 0.0f);
+
+/// Compute the collision manifold between a capsule and a circle.
+void cb2CollideCapsuleAndCircle(cb2Manifold* manifold,
+								const cb2CapsuleShape* capsuleA, const cb2Transform& xfA,
+								const cb2CircleShape* circleB, const cb2Transform& xfB,
+								float margin = 0.0f);
+
+/// Compute the collision manifold between two capsules. Nearly parallel capsules
+/// that overlap along their length get two points.
+void cb2CollideCapsules(cb2Manifold* manifold,
+						const cb2CapsuleShape* capsuleA, const cb2Transform& xfA,
+						const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+						float margin = 0.0f);
+
+/// Compute the collision manifold between a polygon and a capsule. The cache
+/// is used as in cb2CollidePolygons.
+void cb2CollidePolygonAndCapsule(cb2Manifold* manifold,
+								 const cb2PolygonShape* polygonA, const cb2Transform& xfA,
+								 const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+								 cb2PolygonCache* cache = NULL, float margin = 0.0f);
+
+/// Compute the collision manifold between an edge and a capsule.
+/// This accounts for edge connectivity.
+void cb2CollideEdgeAndCapsule(cb2Manifold* manifold,
+							  const cb2EdgeShape* edgeA, const cb2Transform& xfA,
+							  const cb2CapsuleShape* capsuleB, const cb2Transform& xfB,
+							  float margin = 0.0f);
 
 /// Clipping for contact manifolds.
 int cb2ClipSegmentToLine(cb2ClipVertex vOut[2], const cb2ClipVertex vIn[2],
 							const ci::Vec2f& normal, float offset, int vertexIndexA);
 
+/// Compute the closest points of segments p1-q1 and p2-q2 as the fractions s
+/// and t along each segment.
+void cb2ClosestSegmentPoints(float* s, float* t,
+							 const ci::Vec2f& p1, const ci::Vec2f& q1,
+							 const ci::Vec2f& p2, const ci::Vec2f& q2);
+
+/// Correct the face manifold of two rounded convex cores near their corners.
+/// Pass two vertices and no normals for a segment.
+void cb2RoundManifold(cb2Manifold* manifold,
+					  const ci::Vec2f* verticesA, const ci::Vec2f* normalsA, int countA,
+					  float radiusA, const cb2Transform& xfA,
+					  const ci::Vec2f* verticesB, const ci::Vec2f* normalsB, int countB,
+					  float radiusB, const cb2Transform& xfB, float margin = 0.0f);
+
 /// Determine if two generic shapes overlap.
+/// @param cache optional simplex cache kept by the caller for this pair. It
+/// warm starts the distance query and is updated on return.
 bool cb2TestOverlap(	const cb2Shape* shapeA, int indexA,
 					const cb2Shape* shapeB, int indexB,
-					const cb2Transform& xfA, const cb2Transform& xfB);
+					const cb2Transform& xfA, const cb2Transform& xfB,
+					cb2SimplexCache* cache = NULL);
 
 // ---------------- Inline Functions ------------------------------------------
 
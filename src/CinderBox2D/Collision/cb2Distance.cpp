@@ -21,6 +21,8 @@
 #include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
 
 // GJK using Voronoi regions (Christer Ericson) and Barycentric coordinates.
 int cb2_gjkCalls, cb2_gjkIters, cb2_gjkMaxIters;
@@ -77,6 +79,32 @@ void cb2DistanceProxy::set(const cb2Shape* shape, int index)
 		}
 		break;
 
+	case cb2Shape::e_capsule:
+		{
+			const cb2CapsuleShape* capsule = static_cast<const cb2CapsuleShape*>(shape);
+			m_vertices = &capsule->m_vertex1;
+			m_count = 2;
+			m_radius = capsule->m_radius;
+		}
+		break;
+
+	case cb2Shape::e_mesh:
+		{
+			const cb2MeshShape* mesh = static_cast<const cb2MeshShape*>(shape);
+			cb2Assert(0 <= index && index < mesh->m_pieceCount);
+
+			const int* piece = mesh->m_indices + mesh->m_pieceSize * index;
+			for (int i = 0; i < mesh->m_pieceSize; ++i)
+			{
+				m_buffer[i] = mesh->m_vertices[piece[i]];
+			}
+
+			m_vertices = m_buffer;
+			m_count = mesh->m_pieceSize;
+			m_radius = mesh->m_radius;
+		}
+		break;
+
 	default:
 		cb2Assert(false);
 	}
@@ -46,7 +46,7 @@ struct cb2DistanceProxy
 	/// Get a vertex by index. Used by cb2Distance.
 	const ci::Vec2f& GetVertex(int index) const;
 
-	ci::Vec2f m_buffer[2];
+	ci::Vec2f m_buffer[3];
 	const ci::Vec2f* m_vertices;
 	int m_count;
 	float m_radius;
@@ -106,16 +106,23 @@ inline const ci::Vec2f& cb2DistanceProxy::GetVertex(int index) const
 
 inline int cb2DistanceProxy::GetSupport(const ci::Vec2f& d) const
 {
+	cb2Assert(m_count <= cb2_maxPolygonVertices);
+
+	// Project every vertex first, then select the maximum with conditional
+	// moves instead of branches. The reduction keeps the first maximum.
+	float values[cb2_maxPolygonVertices];
+	for (int i = 0; i < m_count; ++i)
+	{
+		values[i] = m_vertices[i].x * d.x + m_vertices[i].y * d.y;
+	}
+
 	int bestIndex = 0;
-	float bestValue = cb2Dot(m_vertices[0], d);
+	float bestValue = values[0];
 	for (int i = 1; i < m_count; ++i)
 	{
-		float value = cb2Dot(m_vertices[i], d);
-		if (value > bestValue)
-		{
-			bestIndex = i;
-			bestValue = value;
-		}
+		bool better = values[i] > bestValue;
+		bestIndex = better ? i : bestIndex;
+		bestValue = better ? values[i] : bestValue;
 	}
 
 	return bestIndex;
@@ -123,19 +130,7 @@ inline int cb2DistanceProxy::GetSupport(const ci::Vec2f& d) const
 
 inline const ci::Vec2f& cb2DistanceProxy::GetSupportVertex(const ci::Vec2f& d) const
 {
-	int bestIndex = 0;
-	float bestValue = cb2Dot(m_vertices[0], d);
-	for (int i = 1; i < m_count; ++i)
-	{
-		float value = cb2Dot(m_vertices[i], d);
-		if (value > bestValue)
-		{
-			bestIndex = i;
-			bestValue = value;
-		}
-	}
-
-	return m_vertices[bestIndex];
+	return m_vertices[GetSupport(d)];
 }
 
 #endif
@@ -19,6 +19,222 @@
 #include <CinderBox2D/Collision/cb2DynamicTree.h>
 #include <memory.h>
 
+// Number of bins used to search for a SAH split.
+#define cb2_sahBinCount 16
+
+// Beyond this depth the builders split the items in half, which bounds the
+// recursion for pathological distributions.
+#define cb2_maxBuildDepth 64
+
+// The SAH cost of a subtree: the summed perimeters of its internal nodes.
+inline float cb2GetSubtreeCost(const cb2TreeNode* node)
+{
+	return node->IsLeaf() ? 0.0f : node->cost * node->aabb.GetPerimeter();
+}
+
+// Record the cost of a node whose children are final.
+inline void cb2SetBuiltCost(cb2TreeNode* node, const cb2TreeNode* nodes)
+{
+	float perimeter = node->aabb.GetPerimeter();
+	float sum = perimeter + cb2GetSubtreeCost(nodes + node->child1) + cb2GetSubtreeCost(nodes + node->child2);
+	node->cost = sum / perimeter;
+	node->enlarged = false;
+}
+
+// Split the items with a binned surface area heuristic along the longest axis of
+// their centers. A split costs the perimeter of each side times its item count.
+// The items are partitioned in place and the size of the first side is returned.
+static int cb2PartitionSAH(int* items, int count, const cb2TreeNode* nodes)
+{
+	cb2Assert(count > 1);
+
+	ci::Vec2f lower = nodes[items[0]].aabb.GetCenter();
+	ci::Vec2f upper = lower;
+	for (int i = 1; i < count; ++i)
+	{
+		ci::Vec2f c = nodes[items[i]].aabb.GetCenter();
+		lower = cb2Min(lower, c);
+		upper = cb2Max(upper, c);
+	}
+
+	ci::Vec2f d = upper - lower;
+	bool xAxis = d.x >= d.y;
+	float minCenter = xAxis ? lower.x : lower.y;
+	float extent = xAxis ? d.x : d.y;
+	if (extent <= 0.0f)
+	{
+		// All centers coincide.
+		return count / 2;
+	}
+
+	float scale = cb2_sahBinCount / extent;
+
+	int binCounts[cb2_sahBinCount];
+	cb2AABB binBounds[cb2_sahBinCount];
+	for (int i = 0; i < cb2_sahBinCount; ++i)
+	{
+		binCounts[i] = 0;
+	}
+
+	for (int i = 0; i < count; ++i)
+	{
+		const cb2AABB& aabb = nodes[items[i]].aabb;
+		ci::Vec2f c = aabb.GetCenter();
+		int bin = int(((xAxis ? c.x : c.y) - minCenter) * scale);
+		bin = cb2Clamp(bin, 0, cb2_sahBinCount - 1);
+
+		if (binCounts[bin] == 0)
+		{
+			binBounds[bin] = aabb;
+		}
+		else
+		{
+			binBounds[bin].Combine(aabb);
+		}
+		++binCounts[bin];
+	}
+
+	// Sweep from the right to get the cost of each right side.
+	float rightCosts[cb2_sahBinCount];
+	cb2AABB bounds;
+	int n = 0;
+	for (int i = cb2_sahBinCount - 1; i > 0; --i)
+	{
+		if (binCounts[i] > 0)
+		{
+			if (n == 0)
+			{
+				bounds = binBounds[i];
+			}
+			else
+			{
+				bounds.Combine(binBounds[i]);
+			}
+			n += binCounts[i];
+		}
+
+		rightCosts[i] = n > 0 ? n * bounds.GetPerimeter() : -1.0f;
+	}
+
+	// Sweep from the left and keep the cheapest split.
+	float minCost = cb2_maxFloat;
+	int bestBin = -1;
+	n = 0;
+	for (int i = 0; i < cb2_sahBinCount - 1; ++i)
+	{
+		if (binCounts[i] > 0)
+		{
+			if (n == 0)
+			{
+				bounds = binBounds[i];
+			}
+			else
+			{
+				bounds.Combine(binBounds[i]);
+			}
+			n += binCounts[i];
+		}
+
+		if (n == 0 || rightCosts[i + 1] < 0.0f)
+		{
+			continue;
+		}
+
+		float cost = n * bounds.GetPerimeter() + rightCosts[i + 1];
+		if (cost < minCost)
+		{
+			minCost = cost;
+			bestBin = i;
+		}
+	}
+
+	if (bestBin < 0)
+	{
+		return count / 2;
+	}
+
+	int left = 0;
+	int right = count - 1;
+	while (left <= right)
+	{
+		ci::Vec2f c = nodes[items[left]].aabb.GetCenter();
+		int bin = int(((xAxis ? c.x : c.y) - minCenter) * scale);
+		if (bin <= bestBin)
+		{
+			++left;
+		}
+		else
+		{
+			cb2Swap(items[left], items[right]);
+			--right;
+		}
+	}
+
+	cb2Assert(0 < left && left < count);
+	return left;
+}
+
+cb2TreeRebuild::cb2TreeRebuild()
+{
+	m_nodes = NULL;
+	m_proxyIds = NULL;
+	m_items = NULL;
+	m_leafCount = 0;
+	m_nodeCount = 0;
+	m_capacity = 0;
+	m_root = cb2_nullNode;
+	m_version = 0;
+	m_built = false;
+}
+
+cb2TreeRebuild::~cb2TreeRebuild()
+{
+	cb2Free(m_nodes);
+	cb2Free(m_proxyIds);
+	cb2Free(m_items);
+}
+
+void cb2TreeRebuild::Build()
+{
+	m_nodeCount = m_leafCount;
+	m_root = cb2_nullNode;
+
+	if (m_leafCount > 0)
+	{
+		for (int i = 0; i < m_leafCount; ++i)
+		{
+			m_items[i] = i;
+		}
+
+		m_root = BuildNode(m_items, m_leafCount, 0);
+	}
+
+	m_built = true;
+}
+
+int cb2TreeRebuild::BuildNode(int* items, int count, int depth)
+{
+	if (count == 1)
+	{
+		return items[0];
+	}
+
+	int split = depth < cb2_maxBuildDepth ? cb2PartitionSAH(items, count, m_nodes) : count / 2;
+	int child1 = BuildNode(items, split, depth + 1);
+	int child2 = BuildNode(items + split, count - split, depth + 1);
+
+	cb2Assert(m_nodeCount < 2 * m_capacity);
+	int nodeId = m_nodeCount++;
+	cb2TreeNode* node = m_nodes + nodeId;
+	node->child1 = child1;
+	node->child2 = child2;
+	node->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+	node->height = 1 + cb2Max(m_nodes[child1].height, m_nodes[child2].height);
+	m_nodes[child1].parent = nodeId;
+	m_nodes[child2].parent = nodeId;
+	return nodeId;
+}
+
 cb2DynamicTree::cb2DynamicTree()
 {
 	m_root = cb2_nullNode;
@@ -41,6 +257,9 @@ cb2DynamicTree::cb2DynamicTree()
 	m_path = 0;
 
 	m_insertionCount = 0;
+
+	m_proxyCount = 0;
+	m_version = 0;
 }
 
 cb2DynamicTree::~cb2DynamicTree()
@@ -84,6 +303,8 @@ int cb2DynamicTree::AllocateNode()
 	m_nodes[nodeId].child2 = cb2_nullNode;
 	m_nodes[nodeId].height = 0;
 	m_nodes[nodeId].userData = NULL;
+	m_nodes[nodeId].enlarged = false;
+	m_nodes[nodeId].cost = 0.0f;
 	++m_nodeCount;
 	return nodeId;
 }
@@ -112,9 +333,13 @@ int cb2DynamicTree::CreateProxy(const cb2AABB& aabb, void* userData)
 	m_nodes[proxyId].aabb.upperBound = aabb.upperBound + r;
 	m_nodes[proxyId].userData = userData;
 	m_nodes[proxyId].height = 0;
+	m_nodes[proxyId].enlarged = true;
 
 	InsertLeaf(proxyId);
 
+	++m_proxyCount;
+	++m_version;
+
 	return proxyId;
 }
 
@@ -125,21 +350,15 @@ void cb2DynamicTree::DestroyProxy(int proxyId)
 
 	RemoveLeaf(proxyId);
 	FreeNode(proxyId);
+
+	--m_proxyCount;
+	++m_version;
 }
 
-bool cb2DynamicTree::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+// Compute the fat AABB of a moved proxy.
+// Returns false if the current tree AABB can be kept.
+bool cb2DynamicTree::ComputeMovedAABB(cb2AABB* fatAABB, int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement) const
 {
-	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-
-	cb2Assert(m_nodes[proxyId].IsLeaf());
-
-	if (m_nodes[proxyId].aabb.Contains(aabb))
-	{
-		return false;
-	}
-
-	RemoveLeaf(proxyId);
-
 	// Extend AABB.
 	cb2AABB b = aabb;
 	ci::Vec2f r(cb2_aabbExtension, cb2_aabbExtension);
@@ -167,9 +386,359 @@ bool cb2DynamicTree::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f
 		b.upperBound.y += d.y;
 	}
 
+	*fatAABB = b;
+
+	const cb2AABB& treeAABB = m_nodes[proxyId].aabb;
+	if (treeAABB.Contains(aabb))
+	{
+		// The tree AABB still contains the object, but it might be too large.
+		// Perhaps the object was moving fast but has since gone to sleep.
+		cb2AABB hugeAABB;
+		hugeAABB.lowerBound = b.lowerBound - 4.0f * r;
+		hugeAABB.upperBound = b.upperBound + 4.0f * r;
+
+		if (hugeAABB.Contains(treeAABB))
+		{
+			// The tree AABB is not too large. No tree update needed.
+			return false;
+		}
+
+		// Otherwise the tree AABB is huge and needs to be shrunk.
+	}
+
+	return true;
+}
+
+bool cb2DynamicTree::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+
+	cb2Assert(m_nodes[proxyId].IsLeaf());
+
+	cb2AABB b;
+	if (ComputeMovedAABB(&b, proxyId, aabb, displacement) == false)
+	{
+		return false;
+	}
+
+	// A shrunk AABB cannot overlap anything new, so it needs no pair query.
+	bool enlarged = m_nodes[proxyId].aabb.Contains(b) == false;
+
+	RemoveLeaf(proxyId);
+
 	m_nodes[proxyId].aabb = b;
 
 	InsertLeaf(proxyId);
+
+	if (enlarged)
+	{
+		m_nodes[proxyId].enlarged = true;
+	}
+
+	return enlarged;
+}
+
+bool cb2DynamicTree::RefitProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+
+	cb2Assert(m_nodes[proxyId].IsLeaf());
+
+	cb2AABB b;
+	if (ComputeMovedAABB(&b, proxyId, aabb, displacement) == false)
+	{
+		return false;
+	}
+
+	bool enlarged = m_nodes[proxyId].aabb.Contains(b) == false;
+
+	m_nodes[proxyId].aabb = b;
+
+	// Refit the ancestors and mark them for the next rebuild.
+	int index = m_nodes[proxyId].parent;
+	while (index != cb2_nullNode)
+	{
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
+		m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+		m_nodes[index].enlarged = true;
+
+		index = m_nodes[index].parent;
+	}
+
+	if (enlarged)
+	{
+		m_nodes[proxyId].enlarged = true;
+	}
+
+	return enlarged;
+}
+
+int cb2DynamicTree::BuildNode(int* items, int count, int depth)
+{
+	if (count == 1)
+	{
+		return items[0];
+	}
+
+	int split = depth < cb2_maxBuildDepth ? cb2PartitionSAH(items, count, m_nodes) : count / 2;
+	int child1 = BuildNode(items, split, depth + 1);
+	int child2 = BuildNode(items + split, count - split, depth + 1);
+
+	int nodeId = AllocateNode();
+	cb2TreeNode* node = m_nodes + nodeId;
+	node->child1 = child1;
+	node->child2 = child2;
+	node->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+	node->height = 1 + cb2Max(m_nodes[child1].height, m_nodes[child2].height);
+	cb2SetBuiltCost(node, m_nodes);
+	m_nodes[child1].parent = nodeId;
+	m_nodes[child2].parent = nodeId;
+	return nodeId;
+}
+
+int cb2DynamicTree::Rebuild(bool fullBuild)
+{
+	if (m_root == cb2_nullNode || m_nodes[m_root].IsLeaf())
+	{
+		return 0;
+	}
+
+	if (fullBuild == false && m_nodes[m_root].enlarged == false)
+	{
+		return 0;
+	}
+
+	return RebuildNode(m_root, fullBuild);
+}
+
+// Rebuild the subtree below an internal node in place.
+int cb2DynamicTree::RebuildNode(int nodeId, bool fullBuild)
+{
+	int parent = m_nodes[nodeId].parent;
+
+	int* items = (int*)cb2Alloc(m_nodeCount * sizeof(int));
+	int count = 0;
+
+	// Collect the leaves and the untouched subtrees below the refit nodes.
+	// The refit nodes are freed and replaced by the build.
+	cb2GrowableStack<int, 256> stack;
+	stack.Push(nodeId);
+
+	while (stack.GetCount() > 0)
+	{
+		int index = stack.Pop();
+		cb2TreeNode* node = m_nodes + index;
+
+		if (node->IsLeaf() || (fullBuild == false && node->enlarged == false))
+		{
+			node->parent = cb2_nullNode;
+			items[count] = index;
+			++count;
+			continue;
+		}
+
+		stack.Push(node->child1);
+		stack.Push(node->child2);
+		FreeNode(index);
+	}
+
+	int root = BuildNode(items, count, 0);
+	m_nodes[root].parent = parent;
+
+	cb2Free(items);
+
+	if (parent == cb2_nullNode)
+	{
+		m_root = root;
+		return count;
+	}
+
+	if (m_nodes[parent].child1 == nodeId)
+	{
+		m_nodes[parent].child1 = root;
+	}
+	else
+	{
+		m_nodes[parent].child2 = root;
+	}
+
+	// The bounds above are unchanged, but the heights may not be.
+	for (int index = parent; index != cb2_nullNode; index = m_nodes[index].parent)
+	{
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
+		m_nodes[index].height = 1 + cb2Max(m_nodes[child1].height, m_nodes[child2].height);
+	}
+
+	return count;
+}
+
+// Sum the perimeters of the internal nodes below a node. Unchanged subtrees
+// still have their built cost. The sums of the changed nodes go into costs.
+float cb2DynamicTree::ComputeCost(int nodeId, float* costs) const
+{
+	const cb2TreeNode* node = m_nodes + nodeId;
+	if (node->IsLeaf())
+	{
+		return 0.0f;
+	}
+
+	if (node->enlarged == false)
+	{
+		return cb2GetSubtreeCost(node);
+	}
+
+	float sum = node->aabb.GetPerimeter() + ComputeCost(node->child1, costs) + ComputeCost(node->child2, costs);
+	costs[nodeId] = sum;
+	return sum;
+}
+
+int cb2DynamicTree::RebuildDegraded(float factor)
+{
+	if (m_root == cb2_nullNode || m_nodes[m_root].IsLeaf() || m_nodes[m_root].enlarged == false)
+	{
+		return 0;
+	}
+
+	float* costs = (float*)cb2Alloc(m_nodeCapacity * sizeof(float));
+	ComputeCost(m_root, costs);
+
+	// Rebuild the highest degraded nodes. Changed nodes that are still good keep
+	// their flag and built cost, so they are measured again next time.
+	int count = 0;
+	cb2GrowableStack<int, 256> stack;
+	stack.Push(m_root);
+
+	while (stack.GetCount() > 0)
+	{
+		int nodeId = stack.Pop();
+		const cb2TreeNode* node = m_nodes + nodeId;
+		if (node->IsLeaf() || node->enlarged == false)
+		{
+			continue;
+		}
+
+		if (costs[nodeId] > factor * node->cost * node->aabb.GetPerimeter())
+		{
+			count += RebuildNode(nodeId, false);
+			continue;
+		}
+
+		stack.Push(node->child1);
+		stack.Push(node->child2);
+	}
+
+	cb2Free(costs);
+
+	return count;
+}
+
+void cb2DynamicTree::BeginRebuild(cb2TreeRebuild* rebuild) const
+{
+	if (rebuild->m_capacity < m_proxyCount)
+	{
+		cb2Free(rebuild->m_nodes);
+		cb2Free(rebuild->m_proxyIds);
+		cb2Free(rebuild->m_items);
+
+		rebuild->m_capacity = m_proxyCount;
+		rebuild->m_nodes = (cb2TreeNode*)cb2Alloc(2 * rebuild->m_capacity * sizeof(cb2TreeNode));
+		rebuild->m_proxyIds = (int*)cb2Alloc(rebuild->m_capacity * sizeof(int));
+		rebuild->m_items = (int*)cb2Alloc(rebuild->m_capacity * sizeof(int));
+	}
+
+	int count = 0;
+	for (int i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height != 0)
+		{
+			// Free or internal node
+			continue;
+		}
+
+		cb2TreeNode* leaf = rebuild->m_nodes + count;
+		leaf->aabb = m_nodes[i].aabb;
+		leaf->userData = NULL;
+		leaf->parent = cb2_nullNode;
+		leaf->child1 = cb2_nullNode;
+		leaf->child2 = cb2_nullNode;
+		leaf->height = 0;
+		leaf->enlarged = false;
+		rebuild->m_proxyIds[count] = i;
+		++count;
+	}
+
+	cb2Assert(count == m_proxyCount);
+	rebuild->m_leafCount = count;
+	rebuild->m_nodeCount = count;
+	rebuild->m_root = cb2_nullNode;
+	rebuild->m_version = m_version;
+	rebuild->m_built = false;
+}
+
+bool cb2DynamicTree::FinishRebuild(cb2TreeRebuild* rebuild)
+{
+	if (rebuild->m_built == false)
+	{
+		return false;
+	}
+
+	rebuild->m_built = false;
+
+	if (rebuild->m_version != m_version)
+	{
+		// The proxies changed while the snapshot was built.
+		return false;
+	}
+
+	// Free the internal nodes.
+	for (int i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height > 0)
+		{
+			FreeNode(i);
+		}
+	}
+
+	if (rebuild->m_root == cb2_nullNode)
+	{
+		m_root = cb2_nullNode;
+		return true;
+	}
+
+	// Map snapshot nodes to tree nodes. Build creates children before their parent,
+	// so a single forward pass refits the internal nodes to the current leaf AABBs.
+	int* map = (int*)cb2Alloc(rebuild->m_nodeCount * sizeof(int));
+	for (int i = 0; i < rebuild->m_leafCount; ++i)
+	{
+		map[i] = rebuild->m_proxyIds[i];
+	}
+
+	for (int i = rebuild->m_leafCount; i < rebuild->m_nodeCount; ++i)
+	{
+		const cb2TreeNode* source = rebuild->m_nodes + i;
+		int nodeId = AllocateNode();
+		int child1 = map[source->child1];
+		int child2 = map[source->child2];
+
+		cb2TreeNode* node = m_nodes + nodeId;
+		node->child1 = child1;
+		node->child2 = child2;
+		node->height = source->height;
+		node->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+		cb2SetBuiltCost(node, m_nodes);
+		m_nodes[child1].parent = nodeId;
+		m_nodes[child2].parent = nodeId;
+
+		map[i] = nodeId;
+	}
+
+	m_root = map[rebuild->m_root];
+	m_nodes[m_root].parent = cb2_nullNode;
+
+	cb2Free(map);
+
 	return true;
 }
 
@@ -306,6 +875,7 @@ void cb2DynamicTree::InsertLeaf(int leaf)
 
 		m_nodes[index].height = 1 + cb2Max(m_nodes[child1].height, m_nodes[child2].height);
 		m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+		m_nodes[index].enlarged = true;
 
 		index = m_nodes[index].parent;
 	}
@@ -358,6 +928,7 @@ void cb2DynamicTree::RemoveLeaf(int leaf)
 
 			m_nodes[index].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
 			m_nodes[index].height = 1 + cb2Max(m_nodes[child1].height, m_nodes[child2].height);
+			m_nodes[index].enlarged = true;
 
 			index = m_nodes[index].parent;
 		}
@@ -405,6 +976,8 @@ int cb2DynamicTree::Balance(int iA)
 		cb2Assert(0 <= iG && iG < m_nodeCapacity);
 
 		// Swap A and C
+		A->enlarged = true;
+		C->enlarged = true;
 		C->child1 = iA;
 		C->parent = A->parent;
 		A->parent = iC;
@@ -465,6 +1038,8 @@ int cb2DynamicTree::Balance(int iA)
 		cb2Assert(0 <= iE && iE < m_nodeCapacity);
 
 		// Swap A and B
+		A->enlarged = true;
+		B->enlarged = true;
 		B->child1 = iA;
 		B->parent = A->parent;
 		A->parent = iB;
@@ -752,6 +1327,7 @@ void cb2DynamicTree::RebuildBottomUp()
 		parent->height = 1 + cb2Max(child1->height, child2->height);
 		parent->aabb.Combine(child1->aabb, child2->aabb);
 		parent->parent = cb2_nullNode;
+		cb2SetBuiltCost(parent, m_nodes);
 
 		child1->parent = parentIndex;
 		child2->parent = parentIndex;
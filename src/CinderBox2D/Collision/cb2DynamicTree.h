@@ -48,6 +48,48 @@ struct cb2TreeNode
 
 	// leaf = 0, free node = -1
 	int height;
+
+	/// Set when a leaf's fat AABB grew and it still needs a pair query.
+	/// On an internal node this marks a refit or a change below it since it was built.
+	bool enlarged;
+
+	/// The SAH cost of an internal node's subtree relative to its own perimeter
+	/// when it was built. Zero for nodes made by insertion.
+	float cost;
+};
+
+/// A snapshot of the tree leaves for a full rebuild away from the time step.
+/// Fill it with cb2DynamicTree::BeginRebuild, call Build, then swap the result in
+/// with cb2DynamicTree::FinishRebuild at a step boundary. Build only touches the
+/// snapshot, so it may run on a worker thread while the world keeps stepping.
+class cb2TreeRebuild
+{
+public:
+	cb2TreeRebuild();
+	~cb2TreeRebuild();
+
+	/// Build the new topology with a binned SAH. Does not access the tree.
+	void Build();
+
+	/// Has Build finished on this snapshot?
+	bool IsBuilt() const { return m_built; }
+
+private:
+
+	friend class cb2DynamicTree;
+
+	int BuildNode(int* items, int count, int depth);
+
+	// Leaves first, then the internal nodes created by Build.
+	cb2TreeNode* m_nodes;
+	int* m_proxyIds;
+	int* m_items;
+	int m_leafCount;
+	int m_nodeCount;
+	int m_capacity;
+	int m_root;
+	int m_version;
+	bool m_built;
 };
 
 /// A dynamic AABB tree broad-phase, inspired by Nathanael Presson's btDbvt.
@@ -74,15 +116,47 @@ public:
 	void DestroyProxy(int proxyId);
 
 	/// Move a proxy with a swepted AABB. If the proxy has moved outside of its fattened AABB,
-	/// then the proxy is removed from the tree and re-inserted. Otherwise
-	/// the function returns immediately.
-	/// @return true if the proxy was re-inserted.
+	/// then the proxy is removed from the tree and re-inserted. A fattened AABB that has
+	/// become much larger than needed is shrunk. Otherwise the function returns immediately.
+	/// @return true if the fattened AABB grew, so the proxy may have new pairs.
 	bool MoveProxy(int proxyId, const cb2AABB& aabb1, const ci::Vec2f& displacement);
 
+	/// Move a proxy like MoveProxy, but keep the leaf in place and refit its
+	/// ancestors. This is much cheaper than a re-insertion, but the tree quality
+	/// degrades until the refit nodes are rebuilt with Rebuild.
+	/// @return true if the fattened AABB grew, so the proxy may have new pairs.
+	bool RefitProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement);
+
+	/// Rebuild the part of the tree above the nodes refit by RefitProxy with a
+	/// binned SAH build. Subtrees without refit nodes are kept as they are.
+	/// @param fullBuild rebuild the whole tree from its leaves.
+	/// @return the number of leaves and subtrees that were re-sorted.
+	int Rebuild(bool fullBuild);
+
+	/// Rebuild only the changed subtrees whose SAH cost grew by more than factor
+	/// since they were built. This visits the changed nodes, not the whole tree.
+	/// @return the number of leaves and subtrees that were re-sorted.
+	int RebuildDegraded(float factor);
+
+	/// Copy the leaves into a snapshot for a full rebuild.
+	void BeginRebuild(cb2TreeRebuild* rebuild) const;
+
+	/// Replace the tree topology with a built snapshot. The internal nodes are
+	/// refit to the current leaf AABBs. The snapshot is discarded if proxies were
+	/// created or destroyed since BeginRebuild.
+	/// @return true if the rebuilt tree was swapped in.
+	bool FinishRebuild(cb2TreeRebuild* rebuild);
+
 	/// Get proxy user data.
 	/// @return the proxy user data or 0 if the id is invalid.
 	void* GetUserData(int proxyId) const;
 
+	/// Did the fat AABB of this proxy grow since the last pair update?
+	bool WasEnlarged(int proxyId) const;
+
+	/// Clear the enlarged flag after the proxy's pairs were found.
+	void ClearEnlarged(int proxyId);
+
 	/// Get the fat AABB for a proxy.
 	const cb2AABB& GetFatAABB(int proxyId) const;
 
@@ -118,6 +192,9 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Get the number of proxies in the tree.
+	int GetProxyCount() const;
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -133,6 +210,11 @@ private:
 
 	int Balance(int index);
 
+	bool ComputeMovedAABB(cb2AABB* fatAABB, int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement) const;
+	int BuildNode(int* items, int count, int depth);
+	int RebuildNode(int nodeId, bool fullBuild);
+	float ComputeCost(int nodeId, float* costs) const;
+
 	int ComputeHeight() const;
 	int ComputeHeight(int nodeId) const;
 
@@ -151,6 +233,11 @@ private:
 	unsigned int m_path;
 
 	int m_insertionCount;
+
+	int m_proxyCount;
+
+	/// Bumped whenever a proxy is created or destroyed. Used to validate rebuild snapshots.
+	int m_version;
 };
 
 inline void* cb2DynamicTree::GetUserData(int proxyId) const
@@ -159,6 +246,23 @@ inline void* cb2DynamicTree::GetUserData(int proxyId) const
 	return m_nodes[proxyId].userData;
 }
 
+inline int cb2DynamicTree::GetProxyCount() const
+{
+	return m_proxyCount;
+}
+
+inline bool cb2DynamicTree::WasEnlarged(int proxyId) const
+{
+	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	return m_nodes[proxyId].enlarged;
+}
+
+inline void cb2DynamicTree::ClearEnlarged(int proxyId)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+	m_nodes[proxyId].enlarged = false;
+}
+
 inline const cb2AABB& cb2DynamicTree::GetFatAABB(int proxyId) const
 {
 	cb2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
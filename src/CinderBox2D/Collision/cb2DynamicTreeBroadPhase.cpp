@@ -0,0 +1,290 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <CinderBox2D/Collision/cb2DynamicTreeBroadPhase.h>
+#include <CinderBox2D/Collision/cb2BroadPhase.h>
+
+// Forwards tree hits to a virtual broad-phase callback.
+struct cb2TreeCallbackWrapper
+{
+	bool QueryCallback(int proxyId)
+	{
+		return callback->QueryCallback(proxyId);
+	}
+
+	float RayCastCallback(const cb2RayCastInput& input, int proxyId)
+	{
+		return callback->RayCastCallback(input, proxyId);
+	}
+
+	cb2BroadPhaseCallback* callback;
+};
+
+// Gathers the pairs of one moved proxy.
+struct cb2TreePairQuery
+{
+	bool QueryCallback(int proxyId)
+	{
+		// A proxy cannot form a pair with itself.
+		if (proxyId == queryProxyId)
+		{
+			return true;
+		}
+
+		// Both proxies are being queried. Only the one with the higher id reports the pair.
+		if (tree->WasEnlarged(proxyId) && proxyId > queryProxyId)
+		{
+			return true;
+		}
+
+		broadPhase->BufferPair(cb2Min(proxyId, queryProxyId), cb2Max(proxyId, queryProxyId));
+		return true;
+	}
+
+	const cb2DynamicTree* tree;
+	cb2BroadPhase* broadPhase;
+	int queryProxyId;
+};
+
+cb2DynamicTreeBroadPhase::cb2DynamicTreeBroadPhase()
+{
+	m_stats.areaRatio = 0.0f;
+	m_stats.builtAreaRatio = 0.0f;
+	m_stats.maxBalance = 0;
+	m_stats.height = 0;
+	m_stats.sampleCount = 0;
+	m_stats.partialRebuildCount = 0;
+	m_stats.fullRebuildCount = 0;
+
+	m_refitEnabled = false;
+	m_degradeFactor = 1.25f;
+	m_degradeInterval = 8;
+	m_degradeStepCount = 0;
+	m_statsInterval = 0;
+	m_stepCount = 0;
+	m_rebuildFactor = 0.0f;
+	m_rebuildDue = false;
+	m_finishedRebuild = NULL;
+}
+
+void cb2DynamicTreeBroadPhase::SetRefitEnabled(bool flag)
+{
+	if (m_refitEnabled && flag == false)
+	{
+		// Restore the tree quality before going back to re-insertion.
+		m_tree.Rebuild(false);
+	}
+
+	m_refitEnabled = flag;
+}
+
+void cb2DynamicTreeBroadPhase::SetDegradeFactor(float factor)
+{
+	cb2Assert(factor >= 1.0f);
+	m_degradeFactor = factor;
+}
+
+void cb2DynamicTreeBroadPhase::SetDegradeInterval(int interval)
+{
+	cb2Assert(interval > 0);
+	m_degradeInterval = interval;
+	m_degradeStepCount = 0;
+}
+
+void cb2DynamicTreeBroadPhase::SetStatsInterval(int interval)
+{
+	cb2Assert(interval >= 0);
+	m_statsInterval = interval;
+	m_stepCount = 0;
+}
+
+void cb2DynamicTreeBroadPhase::SetRebuildFactor(float factor)
+{
+	cb2Assert(factor == 0.0f || factor >= 1.0f);
+	m_rebuildFactor = factor;
+}
+
+void cb2DynamicTreeBroadPhase::BeginRebuild(cb2TreeRebuild* rebuild)
+{
+	m_tree.BeginRebuild(rebuild);
+	m_rebuildDue = false;
+}
+
+void cb2DynamicTreeBroadPhase::FinishRebuild(cb2TreeRebuild* rebuild)
+{
+	cb2Assert(rebuild->IsBuilt());
+	m_finishedRebuild = rebuild;
+}
+
+int cb2DynamicTreeBroadPhase::CreateProxy(const cb2AABB& aabb, void* userData)
+{
+	return m_tree.CreateProxy(aabb, userData);
+}
+
+void cb2DynamicTreeBroadPhase::DestroyProxy(int proxyId)
+{
+	m_tree.DestroyProxy(proxyId);
+}
+
+bool cb2DynamicTreeBroadPhase::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+{
+	if (m_refitEnabled)
+	{
+		return m_tree.RefitProxy(proxyId, aabb, displacement);
+	}
+
+	return m_tree.MoveProxy(proxyId, aabb, displacement);
+}
+
+void cb2DynamicTreeBroadPhase::FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount)
+{
+	cb2TreePairQuery query;
+	query.tree = &m_tree;
+	query.broadPhase = broadPhase;
+
+	// Perform tree queries for all moving proxies.
+	for (int i = 0; i < moveCount; ++i)
+	{
+		query.queryProxyId = moveBuffer[i];
+		if (query.queryProxyId == cb2BroadPhase::e_nullProxy)
+		{
+			continue;
+		}
+
+		// We have to query the tree with the fat AABB so that
+		// we don't fail to create a pair that may touch later.
+		const cb2AABB& fatAABB = m_tree.GetFatAABB(query.queryProxyId);
+
+		// Query tree, create pairs and add them pair buffer.
+		m_tree.Query(&query, fatAABB);
+	}
+
+	for (int i = 0; i < moveCount; ++i)
+	{
+		if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+		{
+			m_tree.ClearEnlarged(moveBuffer[i]);
+		}
+	}
+}
+
+void cb2DynamicTreeBroadPhase::Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const
+{
+	cb2TreeCallbackWrapper wrapper;
+	wrapper.callback = callback;
+	m_tree.Query(&wrapper, aabb);
+}
+
+void cb2DynamicTreeBroadPhase::RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const
+{
+	cb2TreeCallbackWrapper wrapper;
+	wrapper.callback = callback;
+	m_tree.RayCast(&wrapper, input);
+}
+
+void cb2DynamicTreeBroadPhase::ShiftOrigin(const ci::Vec2f& newOrigin)
+{
+	m_tree.ShiftOrigin(newOrigin);
+}
+
+int cb2DynamicTreeBroadPhase::GetHeight() const
+{
+	return m_tree.GetHeight();
+}
+
+int cb2DynamicTreeBroadPhase::GetMaxBalance() const
+{
+	return m_tree.GetMaxBalance();
+}
+
+float cb2DynamicTreeBroadPhase::GetAreaRatio() const
+{
+	return m_tree.GetAreaRatio();
+}
+
+void cb2DynamicTreeBroadPhase::Maintain()
+{
+	if (m_finishedRebuild)
+	{
+		SwapRebuild();
+	}
+
+	if (m_refitEnabled)
+	{
+		++m_degradeStepCount;
+		if (m_degradeStepCount >= m_degradeInterval)
+		{
+			m_degradeStepCount = 0;
+			if (m_tree.RebuildDegraded(m_degradeFactor) > 0)
+			{
+				++m_stats.partialRebuildCount;
+			}
+		}
+	}
+
+	if (m_statsInterval == 0)
+	{
+		return;
+	}
+
+	++m_stepCount;
+	if (m_stepCount < m_statsInterval)
+	{
+		return;
+	}
+
+	m_stepCount = 0;
+	SampleStats();
+	++m_stats.sampleCount;
+
+	if (m_stats.sampleCount == 1)
+	{
+		m_stats.builtAreaRatio = m_stats.areaRatio;
+		return;
+	}
+
+	if (m_rebuildFactor > 0.0f && m_stats.areaRatio > m_rebuildFactor * m_stats.builtAreaRatio)
+	{
+		m_rebuildDue = true;
+	}
+}
+
+void cb2DynamicTreeBroadPhase::SwapRebuild()
+{
+	cb2TreeRebuild* rebuild = m_finishedRebuild;
+	m_finishedRebuild = NULL;
+
+	if (m_tree.FinishRebuild(rebuild) == false)
+	{
+		// Proxies were created or destroyed while the snapshot was built.
+		m_rebuildDue = true;
+		return;
+	}
+
+	++m_stats.fullRebuildCount;
+	SampleStats();
+	m_stats.builtAreaRatio = m_stats.areaRatio;
+}
+
+void cb2DynamicTreeBroadPhase::SampleStats()
+{
+	m_stats.areaRatio = m_tree.GetAreaRatio();
+	m_stats.maxBalance = m_tree.GetMaxBalance();
+	m_stats.height = m_tree.GetHeight();
+}
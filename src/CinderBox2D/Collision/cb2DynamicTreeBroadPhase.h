@@ -0,0 +1,131 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef CB2_DYNAMIC_TREE_BROAD_PHASE_H
+#define CB2_DYNAMIC_TREE_BROAD_PHASE_H
+
+#include <CinderBox2D/Collision/cb2BroadPhaseBackend.h>
+#include <CinderBox2D/Collision/cb2DynamicTree.h>
+
+/// Tree quality over time, sampled by cb2DynamicTreeBroadPhase::Maintain.
+struct cb2TreeStats
+{
+	float areaRatio;			///< the last sampled cb2DynamicTree::GetAreaRatio
+	float builtAreaRatio;		///< the area ratio after the last full rebuild
+	int maxBalance;				///< the last sampled cb2DynamicTree::GetMaxBalance
+	int height;					///< the last sampled tree height
+	int sampleCount;
+	int partialRebuildCount;
+	int fullRebuildCount;
+};
+
+/// The default broad-phase backend. Proxies are leaves of a cb2DynamicTree
+/// and each moved proxy queries the tree with its fat AABB.
+/// In refit mode moved leaves keep their place and only their ancestors are refit.
+/// Every few steps the refit subtrees whose SAH cost has degraded are rebuilt with
+/// a binned SAH, which costs much less than re-inserting every moved leaf.
+/// A full rebuild is built from a cb2TreeRebuild snapshot away from the time step
+/// and swapped in by Maintain.
+class cb2DynamicTreeBroadPhase : public cb2BroadPhaseBackend
+{
+public:
+	cb2DynamicTreeBroadPhase();
+
+	/// Refit moved proxies in place instead of re-inserting them. Off by default.
+	void SetRefitEnabled(bool flag);
+	bool IsRefitEnabled() const { return m_refitEnabled; }
+
+	/// In refit mode, rebuild a refit subtree when its SAH cost exceeds this factor
+	/// times its cost when it was built. Must be at least one. The default is 1.25.
+	void SetDegradeFactor(float factor);
+
+	/// In refit mode, look for degraded subtrees every interval steps. The default is 8.
+	void SetDegradeInterval(int interval);
+
+	/// Sample the tree statistics every interval steps. Zero disables sampling,
+	/// which is the default since sampling visits every node.
+	void SetStatsInterval(int interval);
+
+	/// Flag a full rebuild as due when a sampled area ratio exceeds this factor
+	/// times the ratio after the last full rebuild. Zero disables the check.
+	/// The tree is not rebuilt inline; see BeginRebuild.
+	void SetRebuildFactor(float factor);
+
+	/// Has a sampled area ratio exceeded the rebuild factor since the last BeginRebuild?
+	bool IsRebuildDue() const { return m_rebuildDue; }
+
+	/// Copy the leaves into a snapshot for a full rebuild. Call this between
+	/// time steps, then call cb2TreeRebuild::Build, e.g. on a worker thread.
+	void BeginRebuild(cb2TreeRebuild* rebuild);
+
+	/// Hand back a snapshot after cb2TreeRebuild::Build has returned. The next
+	/// Maintain swaps it in at the end of the time step. The snapshot must stay
+	/// alive until then. A stale snapshot is dropped and the rebuild stays due.
+	void FinishRebuild(cb2TreeRebuild* rebuild);
+
+	/// Get the tree statistics.
+	const cb2TreeStats& GetStats() const { return m_stats; }
+
+	int CreateProxy(const cb2AABB& aabb, void* userData);
+	void DestroyProxy(int proxyId);
+	bool MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement);
+	void* GetUserData(int proxyId) const;
+	const cb2AABB& GetFatAABB(int proxyId) const;
+	void FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount);
+	void Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const;
+	void RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const;
+	void ShiftOrigin(const ci::Vec2f& newOrigin);
+	int GetHeight() const;
+	int GetMaxBalance() const;
+	float GetAreaRatio() const;
+	void Maintain();
+
+	/// Get the embedded tree.
+	const cb2DynamicTree& GetTree() const { return m_tree; }
+
+private:
+
+	void SampleStats();
+	void SwapRebuild();
+
+	cb2DynamicTree m_tree;
+
+	cb2TreeStats m_stats;
+	bool m_refitEnabled;
+	float m_degradeFactor;
+	int m_degradeInterval;
+	int m_degradeStepCount;
+	int m_statsInterval;
+	int m_stepCount;
+	float m_rebuildFactor;
+	bool m_rebuildDue;
+	cb2TreeRebuild* m_finishedRebuild;
+};
+
+inline void* cb2DynamicTreeBroadPhase::GetUserData(int proxyId) const
+{
+	return m_tree.GetUserData(proxyId);
+}
+
+inline const cb2AABB& cb2DynamicTreeBroadPhase::GetFatAABB(int proxyId) const
+{
+	return m_tree.GetFatAABB(proxyId);
+}
+
+#endif
@@ -0,0 +1,530 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <CinderBox2D/Collision/cb2SpatialHashBroadPhase.h>
+#include <CinderBox2D/Collision/cb2BroadPhase.h>
+#include <memory.h>
+#include <math.h>
+
+cb2SpatialHashBroadPhase::cb2SpatialHashBroadPhase(float cellSize, float margin, int bucketCount)
+{
+	cb2Assert(cellSize > 0.0f);
+	cb2Assert(margin >= 0.0f);
+	cb2Assert(bucketCount > 0);
+
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+	m_margin = margin;
+
+	m_proxyCapacity = 16;
+	m_proxyCount = 0;
+	m_proxies = (cb2HashProxy*)cb2Alloc(m_proxyCapacity * sizeof(cb2HashProxy));
+	for (int i = 0; i < m_proxyCapacity; ++i)
+	{
+		m_proxies[i].next = i + 1;
+		m_proxies[i].active = false;
+	}
+	m_proxies[m_proxyCapacity-1].next = cb2BroadPhase::e_nullProxy;
+	m_freeProxy = 0;
+
+	m_entryCapacity = 64;
+	m_entries = (cb2HashCellEntry*)cb2Alloc(m_entryCapacity * sizeof(cb2HashCellEntry));
+	for (int i = 0; i < m_entryCapacity; ++i)
+	{
+		m_entries[i].next = i + 1;
+	}
+	m_entries[m_entryCapacity-1].next = cb2BroadPhase::e_nullProxy;
+	m_freeEntry = 0;
+
+	int bucketCapacity = cb2IsPowerOfTwo(bucketCount) ? bucketCount : (int)cb2NextPowerOfTwo(bucketCount);
+	m_bucketMask = bucketCapacity - 1;
+	m_buckets = (int*)cb2Alloc(bucketCapacity * sizeof(int));
+	for (int i = 0; i < bucketCapacity; ++i)
+	{
+		m_buckets[i] = cb2BroadPhase::e_nullProxy;
+	}
+}
+
+cb2SpatialHashBroadPhase::~cb2SpatialHashBroadPhase()
+{
+	cb2Free(m_buckets);
+	cb2Free(m_entries);
+	cb2Free(m_proxies);
+}
+
+int cb2SpatialHashBroadPhase::AllocateProxy()
+{
+	if (m_freeProxy == cb2BroadPhase::e_nullProxy)
+	{
+		cb2Assert(m_proxyCount == m_proxyCapacity);
+
+		cb2HashProxy* oldProxies = m_proxies;
+		m_proxyCapacity *= 2;
+		m_proxies = (cb2HashProxy*)cb2Alloc(m_proxyCapacity * sizeof(cb2HashProxy));
+		memcpy(m_proxies, oldProxies, m_proxyCount * sizeof(cb2HashProxy));
+		cb2Free(oldProxies);
+
+		for (int i = m_proxyCount; i < m_proxyCapacity; ++i)
+		{
+			m_proxies[i].next = i + 1;
+			m_proxies[i].active = false;
+		}
+		m_proxies[m_proxyCapacity-1].next = cb2BroadPhase::e_nullProxy;
+		m_freeProxy = m_proxyCount;
+	}
+
+	int proxyId = m_freeProxy;
+	m_freeProxy = m_proxies[proxyId].next;
+	m_proxies[proxyId].active = true;
+	m_proxies[proxyId].moved = false;
+	++m_proxyCount;
+	return proxyId;
+}
+
+void cb2SpatialHashBroadPhase::FreeProxy(int proxyId)
+{
+	m_proxies[proxyId].next = m_freeProxy;
+	m_proxies[proxyId].active = false;
+	m_freeProxy = proxyId;
+	--m_proxyCount;
+}
+
+int cb2SpatialHashBroadPhase::AllocateEntry()
+{
+	if (m_freeEntry == cb2BroadPhase::e_nullProxy)
+	{
+		cb2HashCellEntry* oldEntries = m_entries;
+		int oldCapacity = m_entryCapacity;
+		m_entryCapacity *= 2;
+		m_entries = (cb2HashCellEntry*)cb2Alloc(m_entryCapacity * sizeof(cb2HashCellEntry));
+		memcpy(m_entries, oldEntries, oldCapacity * sizeof(cb2HashCellEntry));
+		cb2Free(oldEntries);
+
+		for (int i = oldCapacity; i < m_entryCapacity; ++i)
+		{
+			m_entries[i].next = i + 1;
+		}
+		m_entries[m_entryCapacity-1].next = cb2BroadPhase::e_nullProxy;
+		m_freeEntry = oldCapacity;
+	}
+
+	int entryId = m_freeEntry;
+	m_freeEntry = m_entries[entryId].next;
+	return entryId;
+}
+
+void cb2SpatialHashBroadPhase::FreeEntry(int entryId)
+{
+	m_entries[entryId].next = m_freeEntry;
+	m_freeEntry = entryId;
+}
+
+inline int cb2SpatialHashBroadPhase::GetCell(float x) const
+{
+	return (int)floorf(x * m_inverseCellSize);
+}
+
+inline int cb2SpatialHashBroadPhase::GetBucket(int cellX, int cellY) const
+{
+	unsigned int h = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+	return (int)(h & (unsigned int)m_bucketMask);
+}
+
+void cb2SpatialHashBroadPhase::ComputeCells(cb2HashProxy* proxy) const
+{
+	proxy->lowerX = GetCell(proxy->aabb.lowerBound.x);
+	proxy->lowerY = GetCell(proxy->aabb.lowerBound.y);
+	proxy->upperX = GetCell(proxy->aabb.upperBound.x);
+	proxy->upperY = GetCell(proxy->aabb.upperBound.y);
+}
+
+void cb2SpatialHashBroadPhase::InsertIntoCells(int proxyId)
+{
+	const cb2HashProxy* proxy = m_proxies + proxyId;
+	for (int y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			// Allocating may grow the entry pool, so take the entry pointer afterwards.
+			int entryId = AllocateEntry();
+			int bucket = GetBucket(x, y);
+			cb2HashCellEntry* entry = m_entries + entryId;
+			entry->proxyId = proxyId;
+			entry->cellX = x;
+			entry->cellY = y;
+			entry->next = m_buckets[bucket];
+			m_buckets[bucket] = entryId;
+		}
+	}
+}
+
+void cb2SpatialHashBroadPhase::RemoveFromCells(int proxyId)
+{
+	const cb2HashProxy* proxy = m_proxies + proxyId;
+	for (int y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			int* link = m_buckets + GetBucket(x, y);
+			while (*link != cb2BroadPhase::e_nullProxy)
+			{
+				cb2HashCellEntry* entry = m_entries + *link;
+				if (entry->proxyId == proxyId && entry->cellX == x && entry->cellY == y)
+				{
+					int entryId = *link;
+					*link = entry->next;
+					FreeEntry(entryId);
+					break;
+				}
+				link = &entry->next;
+			}
+		}
+	}
+}
+
+int cb2SpatialHashBroadPhase::CreateProxy(const cb2AABB& aabb, void* userData)
+{
+	int proxyId = AllocateProxy();
+	cb2HashProxy* proxy = m_proxies + proxyId;
+
+	ci::Vec2f r(m_margin, m_margin);
+	proxy->aabb.lowerBound = aabb.lowerBound - r;
+	proxy->aabb.upperBound = aabb.upperBound + r;
+	proxy->userData = userData;
+	ComputeCells(proxy);
+
+	InsertIntoCells(proxyId);
+	return proxyId;
+}
+
+void cb2SpatialHashBroadPhase::DestroyProxy(int proxyId)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	cb2Assert(m_proxies[proxyId].active);
+
+	RemoveFromCells(proxyId);
+	FreeProxy(proxyId);
+}
+
+bool cb2SpatialHashBroadPhase::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+{
+	CB2_NOT_USED(displacement);
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	cb2HashProxy* proxy = m_proxies + proxyId;
+
+	if (proxy->aabb.Contains(aabb))
+	{
+		return false;
+	}
+
+	ci::Vec2f r(m_margin, m_margin);
+	cb2AABB fatAABB;
+	fatAABB.lowerBound = aabb.lowerBound - r;
+	fatAABB.upperBound = aabb.upperBound + r;
+
+	int lowerX = GetCell(fatAABB.lowerBound.x);
+	int lowerY = GetCell(fatAABB.lowerBound.y);
+	int upperX = GetCell(fatAABB.upperBound.x);
+	int upperY = GetCell(fatAABB.upperBound.y);
+
+	// Only re-bin when the covered cells change.
+	if (lowerX != proxy->lowerX || lowerY != proxy->lowerY ||
+		upperX != proxy->upperX || upperY != proxy->upperY)
+	{
+		RemoveFromCells(proxyId);
+		proxy->aabb = fatAABB;
+		ComputeCells(proxy);
+		InsertIntoCells(proxyId);
+	}
+	else
+	{
+		proxy->aabb = fatAABB;
+	}
+
+	return true;
+}
+
+void cb2SpatialHashBroadPhase::FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount)
+{
+	for (int i = 0; i < moveCount; ++i)
+	{
+		if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+		{
+			m_proxies[moveBuffer[i]].moved = true;
+		}
+	}
+
+	for (int i = 0; i < moveCount; ++i)
+	{
+		if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+		{
+			QueryPairs(broadPhase, moveBuffer[i]);
+		}
+	}
+
+	for (int i = 0; i < moveCount; ++i)
+	{
+		if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+		{
+			m_proxies[moveBuffer[i]].moved = false;
+		}
+	}
+}
+
+void cb2SpatialHashBroadPhase::QueryPairs(cb2BroadPhase* broadPhase, int proxyId)
+{
+	const cb2HashProxy* proxy = m_proxies + proxyId;
+
+	for (int y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			for (int entryId = m_buckets[GetBucket(x, y)]; entryId != cb2BroadPhase::e_nullProxy; entryId = m_entries[entryId].next)
+			{
+				const cb2HashCellEntry* entry = m_entries + entryId;
+				if (entry->cellX != x || entry->cellY != y)
+				{
+					continue;
+				}
+
+				// A proxy cannot form a pair with itself. Two moved proxies
+				// only need to find each other once.
+				int otherId = entry->proxyId;
+				const cb2HashProxy* other = m_proxies + otherId;
+				if (otherId == proxyId || (other->moved && otherId < proxyId))
+				{
+					continue;
+				}
+
+				// Report the pair only in the cell holding the lower corner of the shared cells.
+				if (cb2Max(proxy->lowerX, other->lowerX) != x || cb2Max(proxy->lowerY, other->lowerY) != y)
+				{
+					continue;
+				}
+
+				if (cb2TestOverlap(proxy->aabb, other->aabb))
+				{
+					broadPhase->BufferPair(cb2Min(proxyId, otherId), cb2Max(proxyId, otherId));
+				}
+			}
+		}
+	}
+}
+
+void cb2SpatialHashBroadPhase::Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const
+{
+	int lowerX = GetCell(aabb.lowerBound.x);
+	int lowerY = GetCell(aabb.lowerBound.y);
+	int upperX = GetCell(aabb.upperBound.x);
+	int upperY = GetCell(aabb.upperBound.y);
+
+	// A huge query box is cheaper to answer by visiting every proxy.
+	float cellCount = float(upperX - lowerX + 1) * float(upperY - lowerY + 1);
+	if (cellCount > float(m_proxyCount))
+	{
+		for (int i = 0; i < m_proxyCapacity; ++i)
+		{
+			if (m_proxies[i].active && cb2TestOverlap(m_proxies[i].aabb, aabb))
+			{
+				if (callback->QueryCallback(i) == false)
+				{
+					return;
+				}
+			}
+		}
+		return;
+	}
+
+	for (int y = lowerY; y <= upperY; ++y)
+	{
+		for (int x = lowerX; x <= upperX; ++x)
+		{
+			for (int entryId = m_buckets[GetBucket(x, y)]; entryId != cb2BroadPhase::e_nullProxy; entryId = m_entries[entryId].next)
+			{
+				const cb2HashCellEntry* entry = m_entries + entryId;
+				if (entry->cellX != x || entry->cellY != y)
+				{
+					continue;
+				}
+
+				const cb2HashProxy* proxy = m_proxies + entry->proxyId;
+				if (cb2Max(proxy->lowerX, lowerX) != x || cb2Max(proxy->lowerY, lowerY) != y)
+				{
+					continue;
+				}
+
+				if (cb2TestOverlap(proxy->aabb, aabb))
+				{
+					if (callback->QueryCallback(entry->proxyId) == false)
+					{
+						return;
+					}
+				}
+			}
+		}
+	}
+}
+
+void cb2SpatialHashBroadPhase::RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const
+{
+	ci::Vec2f p1 = input.p1;
+	ci::Vec2f p2 = input.p2;
+	ci::Vec2f d = p2 - p1;
+	ci::Vec2f r = d;
+	cb2Assert(r.lengthSquared() > 0.0f);
+	r.normalize();
+
+	// v is perpendicular to the segment.
+	ci::Vec2f v = cb2Cross(1.0f, r);
+	ci::Vec2f abs_v = cb2Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	cb2AABB segmentAABB;
+	{
+		ci::Vec2f t = p1 + maxFraction * d;
+		segmentAABB.lowerBound = cb2Min(p1, t);
+		segmentAABB.upperBound = cb2Max(p1, t);
+	}
+
+	// Set up the grid walk (Amanatides and Woo). Fractions are along p2 - p1.
+	int x = GetCell(p1.x);
+	int y = GetCell(p1.y);
+	int stepX = d.x > 0.0f ? 1 : (d.x < 0.0f ? -1 : 0);
+	int stepY = d.y > 0.0f ? 1 : (d.y < 0.0f ? -1 : 0);
+
+	float tDeltaX = stepX != 0 ? m_cellSize / cb2Abs(d.x) : cb2_maxFloat;
+	float tDeltaY = stepY != 0 ? m_cellSize / cb2Abs(d.y) : cb2_maxFloat;
+	float tMaxX = cb2_maxFloat;
+	float tMaxY = cb2_maxFloat;
+	if (stepX != 0)
+	{
+		float boundary = (stepX > 0 ? x + 1 : x) * m_cellSize;
+		tMaxX = (boundary - p1.x) / d.x;
+	}
+	if (stepY != 0)
+	{
+		float boundary = (stepY > 0 ? y + 1 : y) * m_cellSize;
+		tMaxY = (boundary - p1.y) / d.y;
+	}
+
+	bool first = true;
+	int prevX = x, prevY = y;
+
+	for (;;)
+	{
+		for (int entryId = m_buckets[GetBucket(x, y)]; entryId != cb2BroadPhase::e_nullProxy; entryId = m_entries[entryId].next)
+		{
+			const cb2HashCellEntry* entry = m_entries + entryId;
+			if (entry->cellX != x || entry->cellY != y)
+			{
+				continue;
+			}
+
+			// The walked cells inside a proxy's cell range are contiguous. If the
+			// previous cell was in range the proxy has already been visited.
+			const cb2HashProxy* proxy = m_proxies + entry->proxyId;
+			if (first == false &&
+				proxy->lowerX <= prevX && prevX <= proxy->upperX &&
+				proxy->lowerY <= prevY && prevY <= proxy->upperY)
+			{
+				continue;
+			}
+
+			if (cb2TestOverlap(proxy->aabb, segmentAABB) == false)
+			{
+				continue;
+			}
+
+			// Separating axis for segment (Gino, p80).
+			// |dot(v, p1 - c)| > dot(|v|, h)
+			ci::Vec2f c = proxy->aabb.GetCenter();
+			ci::Vec2f h = proxy->aabb.GetExtents();
+			float separation = cb2Abs(cb2Dot(v, p1 - c)) - cb2Dot(abs_v, h);
+			if (separation > 0.0f)
+			{
+				continue;
+			}
+
+			cb2RayCastInput subInput;
+			subInput.p1 = input.p1;
+			subInput.p2 = input.p2;
+			subInput.maxFraction = maxFraction;
+
+			float value = callback->RayCastCallback(subInput, entry->proxyId);
+
+			if (value == 0.0f)
+			{
+				// The client has terminated the ray cast.
+				return;
+			}
+
+			if (value > 0.0f)
+			{
+				// Update segment bounding box.
+				maxFraction = value;
+				ci::Vec2f t = p1 + maxFraction * d;
+				segmentAABB.lowerBound = cb2Min(p1, t);
+				segmentAABB.upperBound = cb2Max(p1, t);
+			}
+		}
+
+		// Step to the next cell unless the ray ends in this one.
+		first = false;
+		prevX = x;
+		prevY = y;
+		if (tMaxX < tMaxY)
+		{
+			if (tMaxX > maxFraction)
+			{
+				break;
+			}
+			x += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			if (tMaxY > maxFraction)
+			{
+				break;
+			}
+			y += stepY;
+			tMaxY += tDeltaY;
+		}
+	}
+}
+
+void cb2SpatialHashBroadPhase::ShiftOrigin(const ci::Vec2f& newOrigin)
+{
+	// Cells are tied to the origin, so all proxies are re-binned.
+	for (int i = 0; i < m_proxyCapacity; ++i)
+	{
+		if (m_proxies[i].active == false)
+		{
+			continue;
+		}
+
+		RemoveFromCells(i);
+		m_proxies[i].aabb.lowerBound -= newOrigin;
+		m_proxies[i].aabb.upperBound -= newOrigin;
+		ComputeCells(m_proxies + i);
+		InsertIntoCells(i);
+	}
+}
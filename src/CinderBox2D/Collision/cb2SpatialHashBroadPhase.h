@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef CB2_SPATIAL_HASH_BROAD_PHASE_H
+#define CB2_SPATIAL_HASH_BROAD_PHASE_H
+
+#include <CinderBox2D/Collision/cb2BroadPhaseBackend.h>
+
+/// A proxy in the spatial hash. The client does not interact with this directly.
+struct cb2HashProxy
+{
+	/// Enlarged AABB
+	cb2AABB aabb;
+
+	void* userData;
+
+	/// Inclusive range of cells covered by the fat AABB.
+	int lowerX, lowerY;
+	int upperX, upperY;
+
+	/// Free list link.
+	int next;
+
+	bool active;
+
+	/// Set while the proxy is in the move buffer.
+	bool moved;
+};
+
+/// One proxy registered in one cell. Entries of all cells that hash
+/// to the same bucket share a list, so the cell is stored for filtering.
+struct cb2HashCellEntry
+{
+	int proxyId;
+	int cellX, cellY;
+	int next;
+};
+
+/// A uniform grid broad-phase backend stored in a spatial hash. A proxy is
+/// registered in every cell its fat AABB touches. Overlaps found in more than
+/// one cell are only reported in the cell holding the lower corner of the
+/// overlap, so pairs and query results come out without duplicates.
+/// Ray casts walk the cells along the ray (DDA).
+/// This suits bounded scenes of similar sized bodies. Choose a cell size a bit
+/// larger than a typical body. Unlike the tree, the fat margin is configurable
+/// and may be zero, in which case moving proxies are re-binned every step.
+class cb2SpatialHashBroadPhase : public cb2BroadPhaseBackend
+{
+public:
+	/// @param cellSize the edge length of a grid cell in meters.
+	/// @param margin the fattening applied to proxy AABBs in meters.
+	/// @param bucketCount the hash table size, rounded up to a power of two.
+	cb2SpatialHashBroadPhase(float cellSize = 1.0f, float margin = cb2_aabbExtension, int bucketCount = 4096);
+	~cb2SpatialHashBroadPhase();
+
+	int CreateProxy(const cb2AABB& aabb, void* userData);
+	void DestroyProxy(int proxyId);
+	bool MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement);
+	void* GetUserData(int proxyId) const;
+	const cb2AABB& GetFatAABB(int proxyId) const;
+	void FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount);
+	void Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const;
+	void RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const;
+	void ShiftOrigin(const ci::Vec2f& newOrigin);
+
+	/// Get the cell size.
+	float GetCellSize() const;
+
+private:
+
+	int AllocateProxy();
+	void FreeProxy(int proxyId);
+
+	int AllocateEntry();
+	void FreeEntry(int entryId);
+
+	int GetCell(float x) const;
+	int GetBucket(int cellX, int cellY) const;
+
+	void ComputeCells(cb2HashProxy* proxy) const;
+	void InsertIntoCells(int proxyId);
+	void RemoveFromCells(int proxyId);
+
+	void QueryPairs(cb2BroadPhase* broadPhase, int proxyId);
+
+	float m_cellSize;
+	float m_inverseCellSize;
+	float m_margin;
+
+	cb2HashProxy* m_proxies;
+	int m_proxyCapacity;
+	int m_proxyCount;
+	int m_freeProxy;
+
+	cb2HashCellEntry* m_entries;
+	int m_entryCapacity;
+	int m_freeEntry;
+
+	int* m_buckets;
+	int m_bucketMask;
+};
+
+inline void* cb2SpatialHashBroadPhase::GetUserData(int proxyId) const
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].userData;
+}
+
+inline const cb2AABB& cb2SpatialHashBroadPhase::GetFatAABB(int proxyId) const
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].aabb;
+}
+
+inline float cb2SpatialHashBroadPhase::GetCellSize() const
+{
+	return m_cellSize;
+}
+
+#endif
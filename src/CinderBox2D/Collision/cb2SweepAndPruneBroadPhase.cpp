@@ -0,0 +1,425 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <CinderBox2D/Collision/cb2SweepAndPruneBroadPhase.h>
+#include <CinderBox2D/Collision/cb2BroadPhase.h>
+#include <memory.h>
+
+cb2SweepAndPruneBroadPhase::cb2SweepAndPruneBroadPhase()
+{
+	m_proxyCapacity = 16;
+	m_proxies = (cb2SweepProxy*)cb2Alloc(m_proxyCapacity * sizeof(cb2SweepProxy));
+
+	// Build a linked list for the free list.
+	for (int i = 0; i < m_proxyCapacity - 1; ++i)
+	{
+		m_proxies[i].next = i + 1;
+		m_proxies[i].sortIndex = -1;
+	}
+	m_proxies[m_proxyCapacity-1].next = cb2BroadPhase::e_nullProxy;
+	m_proxies[m_proxyCapacity-1].sortIndex = -1;
+	m_freeList = 0;
+
+	m_sorted = (int*)cb2Alloc(m_proxyCapacity * sizeof(int));
+	m_count = 0;
+
+	m_maxExtent = 0.0f;
+}
+
+cb2SweepAndPruneBroadPhase::~cb2SweepAndPruneBroadPhase()
+{
+	cb2Free(m_sorted);
+	cb2Free(m_proxies);
+}
+
+// Allocate a proxy from the pool. Grow the pool if necessary.
+int cb2SweepAndPruneBroadPhase::AllocateProxy()
+{
+	if (m_freeList == cb2BroadPhase::e_nullProxy)
+	{
+		cb2Assert(m_count == m_proxyCapacity);
+
+		// The free list is empty. Rebuild a bigger pool.
+		cb2SweepProxy* oldProxies = m_proxies;
+		int* oldSorted = m_sorted;
+		m_proxyCapacity *= 2;
+		m_proxies = (cb2SweepProxy*)cb2Alloc(m_proxyCapacity * sizeof(cb2SweepProxy));
+		memcpy(m_proxies, oldProxies, m_count * sizeof(cb2SweepProxy));
+		cb2Free(oldProxies);
+		m_sorted = (int*)cb2Alloc(m_proxyCapacity * sizeof(int));
+		memcpy(m_sorted, oldSorted, m_count * sizeof(int));
+		cb2Free(oldSorted);
+
+		for (int i = m_count; i < m_proxyCapacity - 1; ++i)
+		{
+			m_proxies[i].next = i + 1;
+			m_proxies[i].sortIndex = -1;
+		}
+		m_proxies[m_proxyCapacity-1].next = cb2BroadPhase::e_nullProxy;
+		m_proxies[m_proxyCapacity-1].sortIndex = -1;
+		m_freeList = m_count;
+	}
+
+	int proxyId = m_freeList;
+	m_freeList = m_proxies[proxyId].next;
+	m_proxies[proxyId].userData = NULL;
+	m_proxies[proxyId].moved = false;
+	return proxyId;
+}
+
+void cb2SweepAndPruneBroadPhase::FreeProxy(int proxyId)
+{
+	m_proxies[proxyId].next = m_freeList;
+	m_proxies[proxyId].sortIndex = -1;
+	m_freeList = proxyId;
+}
+
+int cb2SweepAndPruneBroadPhase::CreateProxy(const cb2AABB& aabb, void* userData)
+{
+	int proxyId = AllocateProxy();
+	cb2SweepProxy* proxy = m_proxies + proxyId;
+
+	// Fatten the aabb.
+	ComputeFatAABB(&proxy->aabb, aabb, ci::Vec2f::zero());
+	proxy->userData = userData;
+	m_maxExtent = cb2Max(m_maxExtent, proxy->aabb.upperBound.x - proxy->aabb.lowerBound.x);
+
+	// Append and insertion sort into place.
+	proxy->sortIndex = m_count;
+	m_sorted[m_count] = proxyId;
+	++m_count;
+	Resort(proxyId);
+
+	return proxyId;
+}
+
+void cb2SweepAndPruneBroadPhase::DestroyProxy(int proxyId)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	cb2Assert(m_proxies[proxyId].sortIndex != -1);
+
+	// Close the gap in the sorted array.
+	for (int i = m_proxies[proxyId].sortIndex; i < m_count - 1; ++i)
+	{
+		m_sorted[i] = m_sorted[i + 1];
+		m_proxies[m_sorted[i]].sortIndex = i;
+	}
+	--m_count;
+
+	FreeProxy(proxyId);
+}
+
+bool cb2SweepAndPruneBroadPhase::MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement)
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	cb2SweepProxy* proxy = m_proxies + proxyId;
+
+	if (proxy->aabb.Contains(aabb))
+	{
+		return false;
+	}
+
+	ComputeFatAABB(&proxy->aabb, aabb, displacement);
+	m_maxExtent = cb2Max(m_maxExtent, proxy->aabb.upperBound.x - proxy->aabb.lowerBound.x);
+
+	Resort(proxyId);
+	return true;
+}
+
+void cb2SweepAndPruneBroadPhase::Resort(int proxyId)
+{
+	int index = m_proxies[proxyId].sortIndex;
+	float x = m_proxies[proxyId].aabb.lowerBound.x;
+
+	// Coherent motion only moves a proxy past a few neighbors.
+	while (index > 0 && x < m_proxies[m_sorted[index - 1]].aabb.lowerBound.x)
+	{
+		m_sorted[index] = m_sorted[index - 1];
+		m_proxies[m_sorted[index]].sortIndex = index;
+		--index;
+	}
+
+	while (index < m_count - 1 && m_proxies[m_sorted[index + 1]].aabb.lowerBound.x < x)
+	{
+		m_sorted[index] = m_sorted[index + 1];
+		m_proxies[m_sorted[index]].sortIndex = index;
+		++index;
+	}
+
+	m_sorted[index] = proxyId;
+	m_proxies[proxyId].sortIndex = index;
+}
+
+int cb2SweepAndPruneBroadPhase::FindFirst(float x) const
+{
+	int low = 0;
+	int high = m_count;
+	while (low < high)
+	{
+		int mid = (low + high) >> 1;
+		if (m_proxies[m_sorted[mid]].aabb.lowerBound.x < x)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+void cb2SweepAndPruneBroadPhase::FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount)
+{
+	int movedCount = 0;
+	for (int i = 0; i < moveCount; ++i)
+	{
+		int proxyId = moveBuffer[i];
+		if (proxyId == cb2BroadPhase::e_nullProxy)
+		{
+			continue;
+		}
+
+		m_proxies[proxyId].moved = true;
+		++movedCount;
+	}
+
+	// A full sweep visits every proxy once, so it wins when a good
+	// fraction of the proxies moved.
+	if (4 * movedCount >= m_count)
+	{
+		SweepPairs(broadPhase);
+	}
+	else
+	{
+		for (int i = 0; i < moveCount; ++i)
+		{
+			if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+			{
+				QueryPairs(broadPhase, moveBuffer[i]);
+			}
+		}
+	}
+
+	for (int i = 0; i < moveCount; ++i)
+	{
+		if (moveBuffer[i] != cb2BroadPhase::e_nullProxy)
+		{
+			m_proxies[moveBuffer[i]].moved = false;
+		}
+	}
+}
+
+void cb2SweepAndPruneBroadPhase::QueryPairs(cb2BroadPhase* broadPhase, int proxyId)
+{
+	const cb2AABB& fatAABB = m_proxies[proxyId].aabb;
+
+	for (int i = FindFirst(fatAABB.lowerBound.x - m_maxExtent); i < m_count; ++i)
+	{
+		int otherId = m_sorted[i];
+		const cb2SweepProxy* other = m_proxies + otherId;
+		if (other->aabb.lowerBound.x > fatAABB.upperBound.x)
+		{
+			break;
+		}
+
+		// A proxy cannot form a pair with itself. Two moved proxies
+		// only need to find each other once.
+		if (otherId == proxyId || (other->moved && otherId < proxyId))
+		{
+			continue;
+		}
+
+		if (cb2TestOverlap(fatAABB, other->aabb))
+		{
+			broadPhase->BufferPair(cb2Min(proxyId, otherId), cb2Max(proxyId, otherId));
+		}
+	}
+}
+
+void cb2SweepAndPruneBroadPhase::SweepPairs(cb2BroadPhase* broadPhase)
+{
+	float maxExtent = 0.0f;
+
+	for (int i = 0; i < m_count; ++i)
+	{
+		int proxyId = m_sorted[i];
+		const cb2SweepProxy* proxy = m_proxies + proxyId;
+		maxExtent = cb2Max(maxExtent, proxy->aabb.upperBound.x - proxy->aabb.lowerBound.x);
+
+		// Every later proxy starts to the right of this one, so the
+		// overlaps along x are a contiguous run.
+		for (int j = i + 1; j < m_count; ++j)
+		{
+			int otherId = m_sorted[j];
+			const cb2SweepProxy* other = m_proxies + otherId;
+			if (other->aabb.lowerBound.x > proxy->aabb.upperBound.x)
+			{
+				break;
+			}
+
+			// Pairs between resting proxies are already known to the client.
+			if (proxy->moved == false && other->moved == false)
+			{
+				continue;
+			}
+
+			if (other->aabb.lowerBound.y > proxy->aabb.upperBound.y ||
+				proxy->aabb.lowerBound.y > other->aabb.upperBound.y)
+			{
+				continue;
+			}
+
+			broadPhase->BufferPair(cb2Min(proxyId, otherId), cb2Max(proxyId, otherId));
+		}
+	}
+
+	// The sweep saw every proxy, so tighten the query window.
+	m_maxExtent = maxExtent;
+}
+
+void cb2SweepAndPruneBroadPhase::Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const
+{
+	for (int i = FindFirst(aabb.lowerBound.x - m_maxExtent); i < m_count; ++i)
+	{
+		int proxyId = m_sorted[i];
+		const cb2SweepProxy* proxy = m_proxies + proxyId;
+		if (proxy->aabb.lowerBound.x > aabb.upperBound.x)
+		{
+			break;
+		}
+
+		if (cb2TestOverlap(proxy->aabb, aabb))
+		{
+			bool proceed = callback->QueryCallback(proxyId);
+			if (proceed == false)
+			{
+				return;
+			}
+		}
+	}
+}
+
+void cb2SweepAndPruneBroadPhase::RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const
+{
+	ci::Vec2f p1 = input.p1;
+	ci::Vec2f p2 = input.p2;
+	ci::Vec2f r = p2 - p1;
+	cb2Assert(r.lengthSquared() > 0.0f);
+	r.normalize();
+
+	// v is perpendicular to the segment.
+	ci::Vec2f v = cb2Cross(1.0f, r);
+	ci::Vec2f abs_v = cb2Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	cb2AABB segmentAABB;
+	{
+		ci::Vec2f t = p1 + maxFraction * (p2 - p1);
+		segmentAABB.lowerBound = cb2Min(p1, t);
+		segmentAABB.upperBound = cb2Max(p1, t);
+	}
+
+	for (int i = FindFirst(segmentAABB.lowerBound.x - m_maxExtent); i < m_count; ++i)
+	{
+		int proxyId = m_sorted[i];
+		const cb2SweepProxy* proxy = m_proxies + proxyId;
+		if (proxy->aabb.lowerBound.x > segmentAABB.upperBound.x)
+		{
+			break;
+		}
+
+		if (cb2TestOverlap(proxy->aabb, segmentAABB) == false)
+		{
+			continue;
+		}
+
+		// Separating axis for segment (Gino, p80).
+		// |dot(v, p1 - c)| > dot(|v|, h)
+		ci::Vec2f c = proxy->aabb.GetCenter();
+		ci::Vec2f h = proxy->aabb.GetExtents();
+		float separation = cb2Abs(cb2Dot(v, p1 - c)) - cb2Dot(abs_v, h);
+		if (separation > 0.0f)
+		{
+			continue;
+		}
+
+		cb2RayCastInput subInput;
+		subInput.p1 = input.p1;
+		subInput.p2 = input.p2;
+		subInput.maxFraction = maxFraction;
+
+		float value = callback->RayCastCallback(subInput, proxyId);
+
+		if (value == 0.0f)
+		{
+			// The client has terminated the ray cast.
+			return;
+		}
+
+		if (value > 0.0f)
+		{
+			// Update segment bounding box.
+			maxFraction = value;
+			ci::Vec2f t = p1 + maxFraction * (p2 - p1);
+			segmentAABB.lowerBound = cb2Min(p1, t);
+			segmentAABB.upperBound = cb2Max(p1, t);
+		}
+	}
+}
+
+void cb2SweepAndPruneBroadPhase::ShiftOrigin(const ci::Vec2f& newOrigin)
+{
+	// A uniform shift keeps the sort order.
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2SweepProxy* proxy = m_proxies + m_sorted[i];
+		proxy->aabb.lowerBound -= newOrigin;
+		proxy->aabb.upperBound -= newOrigin;
+	}
+}
+
+void cb2SweepAndPruneBroadPhase::Validate() const
+{
+	for (int i = 0; i < m_count; ++i)
+	{
+		int proxyId = m_sorted[i];
+		cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+		cb2Assert(m_proxies[proxyId].sortIndex == i);
+		cb2Assert(m_proxies[proxyId].aabb.upperBound.x - m_proxies[proxyId].aabb.lowerBound.x <= m_maxExtent);
+		if (i > 0)
+		{
+			cb2Assert(m_proxies[m_sorted[i - 1]].aabb.lowerBound.x <= m_proxies[proxyId].aabb.lowerBound.x);
+		}
+	}
+
+	int freeCount = 0;
+	int freeIndex = m_freeList;
+	while (freeIndex != cb2BroadPhase::e_nullProxy)
+	{
+		cb2Assert(0 <= freeIndex && freeIndex < m_proxyCapacity);
+		cb2Assert(m_proxies[freeIndex].sortIndex == -1);
+		freeIndex = m_proxies[freeIndex].next;
+		++freeCount;
+	}
+
+	cb2Assert(m_count + freeCount == m_proxyCapacity);
+}
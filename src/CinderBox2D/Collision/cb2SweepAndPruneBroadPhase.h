@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef CB2_SWEEP_AND_PRUNE_BROAD_PHASE_H
+#define CB2_SWEEP_AND_PRUNE_BROAD_PHASE_H
+
+#include <CinderBox2D/Collision/cb2BroadPhaseBackend.h>
+
+/// A proxy in the sweep-and-prune backend. The client does not interact with this directly.
+struct cb2SweepProxy
+{
+	/// Enlarged AABB
+	cb2AABB aabb;
+
+	void* userData;
+
+	/// Position in the sorted array, -1 for a free proxy.
+	int sortIndex;
+
+	/// Free list link.
+	int next;
+
+	/// Set while the proxy is in the move buffer.
+	bool moved;
+};
+
+/// A single axis sort-and-sweep broad-phase backend. Proxies are kept sorted
+/// by the lower x bound of their fat AABB and a moved proxy is bubbled to its
+/// new place, which is nearly free when motion is coherent. When many proxies
+/// move at once the pairs are found with one sweep over the whole array instead
+/// of per-proxy queries.
+/// This suits many similar sized bodies moving together (conveyors, crowds,
+/// particles as bodies). It does poorly when many proxies share the same x range,
+/// such as a tall column, because every proxy in the x range is visited.
+class cb2SweepAndPruneBroadPhase : public cb2BroadPhaseBackend
+{
+public:
+	cb2SweepAndPruneBroadPhase();
+	~cb2SweepAndPruneBroadPhase();
+
+	int CreateProxy(const cb2AABB& aabb, void* userData);
+	void DestroyProxy(int proxyId);
+	bool MoveProxy(int proxyId, const cb2AABB& aabb, const ci::Vec2f& displacement);
+	void* GetUserData(int proxyId) const;
+	const cb2AABB& GetFatAABB(int proxyId) const;
+	void FindPairs(cb2BroadPhase* broadPhase, const int* moveBuffer, int moveCount);
+	void Query(cb2BroadPhaseCallback* callback, const cb2AABB& aabb) const;
+	void RayCast(cb2BroadPhaseCallback* callback, const cb2RayCastInput& input) const;
+	void ShiftOrigin(const ci::Vec2f& newOrigin);
+
+	/// Validate the sort order. For testing.
+	void Validate() const;
+
+private:
+
+	int AllocateProxy();
+	void FreeProxy(int proxyId);
+
+	// Move a proxy to its sorted position after the lower bound changed.
+	void Resort(int proxyId);
+
+	// Index of the first sorted proxy with a lower x bound not less than x.
+	int FindFirst(float x) const;
+
+	void QueryPairs(cb2BroadPhase* broadPhase, int proxyId);
+	void SweepPairs(cb2BroadPhase* broadPhase);
+
+	cb2SweepProxy* m_proxies;
+	int m_proxyCapacity;
+	int m_freeList;
+
+	int* m_sorted;
+	int m_count;
+
+	// The widest fat AABB along x. Bounds how far back a query must start.
+	float m_maxExtent;
+};
+
+inline void* cb2SweepAndPruneBroadPhase::GetUserData(int proxyId) const
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].userData;
+}
+
+inline const cb2AABB& cb2SweepAndPruneBroadPhase::GetFatAABB(int proxyId) const
+{
+	cb2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].aabb;
+}
+
+#endif
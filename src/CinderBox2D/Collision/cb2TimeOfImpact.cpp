@@ -252,7 +252,7 @@ struct cb2SeparationFunction
 
 // CCD via the local separating axis method. This seeks progression
 // by computing the largest time at which separation is maintained.
-void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input)
+void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input, cb2SimplexCache* simplexCache)
 {
 	cb2Timer timer;
 
@@ -285,7 +285,14 @@ void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input)
 
 	// Prepare input for distance query.
 	cb2SimplexCache cache;
-	cache.count = 0;
+	if (simplexCache)
+	{
+		cache = *simplexCache;
+	}
+	else
+	{
+		cache.count = 0;
+	}
 	cb2DistanceInput distanceInput;
 	distanceInput.proxyA = input->proxyA;
 	distanceInput.proxyB = input->proxyB;
@@ -479,6 +486,11 @@ void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input)
 		}
 	}
 
+	if (simplexCache)
+	{
+		*simplexCache = cache;
+	}
+
 	cb2_toiMaxIters = cb2Max(cb2_toiMaxIters, iter);
 
 	float time = timer.GetMilliseconds();
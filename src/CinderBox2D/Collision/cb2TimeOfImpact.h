@@ -53,6 +53,8 @@ struct cb2TOIOutput
 /// non-tunneling collision. If you change the time interval, you should call this function
 /// again.
 /// Note: use cb2Distance to compute the contact point and normal at the time of impact.
-void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input);
+/// @param cache optional simplex cache kept by the caller for this pair. It warm
+/// starts the first distance query and holds the last simplex on return.
+void cb2TimeOfImpact(cb2TOIOutput* output, const cb2TOIInput* input, cb2SimplexCache* cache = NULL);
 
 #endif
@@ -71,12 +71,28 @@
 /// Maximum number of sub-steps per contact in continuous physics simulation.
 #define cb2_maxSubSteps			8
 
+/// With manifold reuse, a contact keeps its manifold while the relative motion of its
+/// bodies since the last evaluation stays below these tolerances.
+/// @see cb2World::SetManifoldReuse
+#define cb2_manifoldReuseLinearTolerance	(0.05f * cb2_linearSlop)
+#define cb2_manifoldReuseAngularTolerance	(0.05f * cb2_angularSlop)
+
+/// With speculative contacts, shapes get manifold points when they are apart by less than
+/// this distance plus the distance their bodies close in on each other during the step.
+/// @see cb2World::SetSpeculativeContacts
+#define cb2_speculativeDistance		(4.0f * cb2_linearSlop)
+
 
 // Dynamics
 
 /// Maximum number of contacts to be handled to solve a TOI impact.
 #define cb2_maxTOIContacts			32
 
+/// Maximum number of contact points in an island solved by the direct solver. The
+/// solver factors dense matrices of up to this size squared.
+/// @see cb2World::SetDirectSolverMassRatio
+#define cb2_maxDirectContactPoints	32
+
 /// A velocity threshold for elastic collisions. Any collision with a relative linear
 /// velocity below this threshold will be treated as inelastic.
 #define cb2_velocityThreshold		1.0f
@@ -105,6 +121,18 @@
 #define cb2_baumgarte				0.2f
 #define cb2_toiBaugarte				0.75f
 
+/// The soft step solver treats contacts as springs of this frequency in Hertz. The
+/// frequency is lowered to a quarter of the sub-step rate when needed to stay stable.
+/// @see cb2World::SetSoftSubSteps
+#define cb2_contactHertz			30.0f
+
+/// The damping ratio of soft contacts. Contacts are heavily over damped so that the
+/// push out does not bounce.
+#define cb2_contactDampingRatio		10.0f
+
+/// The maximum velocity at which the soft step solver pushes overlapping shapes apart.
+#define cb2_contactPushVelocity		3.0f
+
 
 // Sleep
 
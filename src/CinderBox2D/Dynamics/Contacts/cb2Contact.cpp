@@ -17,51 +17,57 @@
 */
 
 #include <CinderBox2D/Dynamics/Contacts/cb2Contact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2CircleContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2PolygonAndCircleContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2PolygonContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2EdgeAndCircleContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2EdgeAndPolygonContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2ChainAndCircleContact.h>
-#include <CinderBox2D/Dynamics/Contacts/cb2ChainAndPolygonContact.h>
 #include <CinderBox2D/Dynamics/Contacts/cb2ContactSolver.h>
 
 #include <CinderBox2D/Collision/cb2Collision.h>
 #include <CinderBox2D/Collision/cb2TimeOfImpact.h>
 #include <CinderBox2D/Collision/Shapes/cb2Shape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CircleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
 #include <CinderBox2D/Common/cb2BlockAllocator.h>
 #include <CinderBox2D/Dynamics/cb2Body.h>
 #include <CinderBox2D/Dynamics/cb2Fixture.h>
 #include <CinderBox2D/Dynamics/cb2World.h>
 
+#include <new>
+
 cb2ContactRegister cb2Contact::s_registers[cb2Shape::e_typeCount][cb2Shape::e_typeCount];
 bool cb2Contact::s_initialized = false;
 
 void cb2Contact::InitializeRegisters()
 {
-	AddType(cb2CircleContact::Create, cb2CircleContact::Destroy, cb2Shape::e_circle, cb2Shape::e_circle);
-	AddType(cb2PolygonAndCircleContact::Create, cb2PolygonAndCircleContact::Destroy, cb2Shape::e_polygon, cb2Shape::e_circle);
-	AddType(cb2PolygonContact::Create, cb2PolygonContact::Destroy, cb2Shape::e_polygon, cb2Shape::e_polygon);
-	AddType(cb2EdgeAndCircleContact::Create, cb2EdgeAndCircleContact::Destroy, cb2Shape::e_edge, cb2Shape::e_circle);
-	AddType(cb2EdgeAndPolygonContact::Create, cb2EdgeAndPolygonContact::Destroy, cb2Shape::e_edge, cb2Shape::e_polygon);
-	AddType(cb2ChainAndCircleContact::Create, cb2ChainAndCircleContact::Destroy, cb2Shape::e_chain, cb2Shape::e_circle);
-	AddType(cb2ChainAndPolygonContact::Create, cb2ChainAndPolygonContact::Destroy, cb2Shape::e_chain, cb2Shape::e_polygon);
+	AddType(e_circleContact, cb2Shape::e_circle, cb2Shape::e_circle);
+	AddType(e_polygonAndCircleContact, cb2Shape::e_polygon, cb2Shape::e_circle);
+	AddType(e_polygonContact, cb2Shape::e_polygon, cb2Shape::e_polygon);
+	AddType(e_edgeAndCircleContact, cb2Shape::e_edge, cb2Shape::e_circle);
+	AddType(e_edgeAndPolygonContact, cb2Shape::e_edge, cb2Shape::e_polygon);
+	AddType(e_chainAndCircleContact, cb2Shape::e_chain, cb2Shape::e_circle);
+	AddType(e_chainAndPolygonContact, cb2Shape::e_chain, cb2Shape::e_polygon);
+	AddType(e_capsuleAndCircleContact, cb2Shape::e_capsule, cb2Shape::e_circle);
+	AddType(e_capsuleContact, cb2Shape::e_capsule, cb2Shape::e_capsule);
+	AddType(e_polygonAndCapsuleContact, cb2Shape::e_polygon, cb2Shape::e_capsule);
+	AddType(e_edgeAndCapsuleContact, cb2Shape::e_edge, cb2Shape::e_capsule);
+	AddType(e_chainAndCapsuleContact, cb2Shape::e_chain, cb2Shape::e_capsule);
+	AddType(e_meshAndCircleContact, cb2Shape::e_mesh, cb2Shape::e_circle);
+	AddType(e_meshAndPolygonContact, cb2Shape::e_mesh, cb2Shape::e_polygon);
+	AddType(e_meshAndCapsuleContact, cb2Shape::e_mesh, cb2Shape::e_capsule);
 }
 
-void cb2Contact::AddType(cb2ContactCreateFcn* createFcn, cb2ContactDestroyFcn* destoryFcn,
-						cb2Shape::Type type1, cb2Shape::Type type2)
+void cb2Contact::AddType(cb2ContactType type, cb2Shape::Type type1, cb2Shape::Type type2)
 {
 	cb2Assert(0 <= type1 && type1 < cb2Shape::e_typeCount);
 	cb2Assert(0 <= type2 && type2 < cb2Shape::e_typeCount);
 	
-	s_registers[type1][type2].createFcn = createFcn;
-	s_registers[type1][type2].destroyFcn = destoryFcn;
+	s_registers[type1][type2].type = type;
 	s_registers[type1][type2].primary = true;
 
 	if (type1 != type2)
 	{
-		s_registers[type2][type1].createFcn = createFcn;
-		s_registers[type2][type1].destroyFcn = destoryFcn;
+		s_registers[type2][type1].type = type;
 		s_registers[type2][type1].primary = false;
 	}
 }
@@ -80,21 +86,20 @@ cb2Contact* cb2Contact::Create(cb2Fixture* fixtureA, int indexA, cb2Fixture* fix
 	cb2Assert(0 <= type1 && type1 < cb2Shape::e_typeCount);
 	cb2Assert(0 <= type2 && type2 < cb2Shape::e_typeCount);
 	
-	cb2ContactCreateFcn* createFcn = s_registers[type1][type2].createFcn;
-	if (createFcn)
+	cb2ContactType type = s_registers[type1][type2].type;
+	if (type == e_unknownContact)
 	{
-		if (s_registers[type1][type2].primary)
-		{
-			return createFcn(fixtureA, indexA, fixtureB, indexB, allocator);
-		}
-		else
-		{
-			return createFcn(fixtureB, indexB, fixtureA, indexA, allocator);
-		}
+		return NULL;
+	}
+
+	void* mem = allocator->Allocate(sizeof(cb2Contact));
+	if (s_registers[type1][type2].primary)
+	{
+		return new (mem) cb2Contact(fixtureA, indexA, fixtureB, indexB, type);
 	}
 	else
 	{
-		return NULL;
+		return new (mem) cb2Contact(fixtureB, indexB, fixtureA, indexA, type);
 	}
 }
 
@@ -113,19 +118,17 @@ void cb2Contact::Destroy(cb2Contact* contact, cb2BlockAllocator* allocator)
 		fixtureB->GetBody()->SetAwake(true);
 	}
 
-	cb2Shape::Type typeA = fixtureA->GetType();
-	cb2Shape::Type typeB = fixtureB->GetType();
-
-	cb2Assert(0 <= typeA && typeB < cb2Shape::e_typeCount);
-	cb2Assert(0 <= typeA && typeB < cb2Shape::e_typeCount);
-
-	cb2ContactDestroyFcn* destroyFcn = s_registers[typeA][typeB].destroyFcn;
-	destroyFcn(contact, allocator);
+	contact->~cb2Contact();
+	allocator->Free(contact, sizeof(cb2Contact));
 }
 
-cb2Contact::cb2Contact(cb2Fixture* fA, int indexA, cb2Fixture* fB, int indexB)
+cb2Contact::cb2Contact(cb2Fixture* fA, int indexA, cb2Fixture* fB, int indexB, cb2ContactType type)
 {
+	cb2Assert(s_registers[fA->GetType()][fB->GetType()].type == type);
+	cb2Assert(s_registers[fA->GetType()][fB->GetType()].primary);
+
 	m_flags = e_enabledFlag;
+	m_type = type;
 
 	m_fixtureA = fA;
 	m_fixtureB = fB;
@@ -152,13 +155,173 @@ cb2Contact::cb2Contact(cb2Fixture* fA, int indexA, cb2Fixture* fB, int indexB)
 
 	m_friction = cb2MixFriction(m_fixtureA->m_friction, m_fixtureB->m_friction);
 	m_restitution = cb2MixRestitution(m_fixtureA->m_restitution, m_fixtureB->m_restitution);
+	m_breakForce = cb2Min(m_fixtureA->m_breakForce, m_fixtureB->m_breakForce);
 
 	m_tangentSpeed = 0.0f;
+	m_speculativeMargin = 0.0f;
+
+	m_polygonCache.edgeA = 0;
+	m_polygonCache.edgeB = 0;
+	m_polygonCache.vertexA = 0;
+	m_polygonCache.vertexB = 0;
+
+	m_simplexCache.count = 0;
+}
+
+void cb2Contact::Evaluate(cb2Manifold* manifold, const cb2Transform& xfA, const cb2Transform& xfB)
+{
+	const cb2Shape* shapeA = m_fixtureA->GetShape();
+	const cb2Shape* shapeB = m_fixtureB->GetShape();
+	float margin = m_speculativeMargin;
+
+	switch (m_type)
+	{
+	case e_circleContact:
+		cb2CollideCircles(manifold, (cb2CircleShape*)shapeA, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_polygonAndCircleContact:
+		cb2CollidePolygonAndCircle(manifold, (cb2PolygonShape*)shapeA, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_polygonContact:
+		cb2CollidePolygons(manifold, (cb2PolygonShape*)shapeA, xfA, (cb2PolygonShape*)shapeB, xfB, &m_polygonCache, margin);
+		break;
+
+	case e_edgeAndCircleContact:
+		cb2CollideEdgeAndCircle(manifold, (cb2EdgeShape*)shapeA, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_edgeAndPolygonContact:
+		cb2CollideEdgeAndPolygon(manifold, (cb2EdgeShape*)shapeA, xfA, (cb2PolygonShape*)shapeB, xfB, margin);
+		break;
+
+	case e_chainAndCircleContact:
+		{
+			cb2EdgeShape edge;
+			((cb2ChainShape*)shapeA)->GetChildEdge(&edge, m_indexA);
+			cb2CollideEdgeAndCircle(manifold, &edge, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+		}
+		break;
+
+	case e_chainAndPolygonContact:
+		{
+			cb2EdgeShape edge;
+			((cb2ChainShape*)shapeA)->GetChildEdge(&edge, m_indexA);
+			cb2CollideEdgeAndPolygon(manifold, &edge, xfA, (cb2PolygonShape*)shapeB, xfB, margin);
+		}
+		break;
+
+	case e_capsuleAndCircleContact:
+		cb2CollideCapsuleAndCircle(manifold, (cb2CapsuleShape*)shapeA, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_capsuleContact:
+		cb2CollideCapsules(manifold, (cb2CapsuleShape*)shapeA, xfA, (cb2CapsuleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_polygonAndCapsuleContact:
+		cb2CollidePolygonAndCapsule(manifold, (cb2PolygonShape*)shapeA, xfA, (cb2CapsuleShape*)shapeB, xfB, &m_polygonCache, margin);
+		break;
+
+	case e_edgeAndCapsuleContact:
+		cb2CollideEdgeAndCapsule(manifold, (cb2EdgeShape*)shapeA, xfA, (cb2CapsuleShape*)shapeB, xfB, margin);
+		break;
+
+	case e_chainAndCapsuleContact:
+		{
+			cb2EdgeShape edge;
+			((cb2ChainShape*)shapeA)->GetChildEdge(&edge, m_indexA);
+			cb2CollideEdgeAndCapsule(manifold, &edge, xfA, (cb2CapsuleShape*)shapeB, xfB, margin);
+		}
+		break;
+
+	case e_meshAndCircleContact:
+		{
+			cb2MeshShape* mesh = (cb2MeshShape*)shapeA;
+			if (mesh->HasSegments())
+			{
+				cb2EdgeShape edge;
+				mesh->GetChildEdge(&edge, m_indexA);
+				cb2CollideEdgeAndCircle(manifold, &edge, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+			}
+			else
+			{
+				cb2PolygonShape triangle;
+				mesh->GetChildPolygon(&triangle, m_indexA);
+				cb2CollidePolygonAndCircle(manifold, &triangle, xfA, (cb2CircleShape*)shapeB, xfB, margin);
+			}
+		}
+		break;
+
+	case e_meshAndPolygonContact:
+		{
+			cb2MeshShape* mesh = (cb2MeshShape*)shapeA;
+			if (mesh->HasSegments())
+			{
+				cb2EdgeShape edge;
+				mesh->GetChildEdge(&edge, m_indexA);
+				cb2CollideEdgeAndPolygon(manifold, &edge, xfA, (cb2PolygonShape*)shapeB, xfB, margin);
+			}
+			else
+			{
+				cb2PolygonShape triangle;
+				mesh->GetChildPolygon(&triangle, m_indexA);
+				cb2CollidePolygons(manifold, &triangle, xfA, (cb2PolygonShape*)shapeB, xfB, &m_polygonCache, margin);
+			}
+		}
+		break;
+
+	case e_meshAndCapsuleContact:
+		{
+			cb2MeshShape* mesh = (cb2MeshShape*)shapeA;
+			if (mesh->HasSegments())
+			{
+				cb2EdgeShape edge;
+				mesh->GetChildEdge(&edge, m_indexA);
+				cb2CollideEdgeAndCapsule(manifold, &edge, xfA, (cb2CapsuleShape*)shapeB, xfB, margin);
+			}
+			else
+			{
+				cb2PolygonShape triangle;
+				mesh->GetChildPolygon(&triangle, m_indexA);
+				cb2CollidePolygonAndCapsule(manifold, &triangle, xfA, (cb2CapsuleShape*)shapeB, xfB, &m_polygonCache, margin);
+			}
+		}
+		break;
+
+	default:
+		cb2Assert(false);
+		break;
+	}
+}
+
+// Has the relative transform of the bodies moved less than the tolerances since the last evaluation?
+bool cb2Contact::IsReusable(const cb2Transform& relativeTransform, float linearTolerance, float angularTolerance) const
+{
+	if ((m_flags & e_evaluatedFlag) == 0 || linearTolerance <= 0.0f)
+	{
+		return false;
+	}
+
+	ci::Vec2f dp = relativeTransform.p - m_relativeTransform.p;
+	if (dp.lengthSquared() > linearTolerance * linearTolerance)
+	{
+		return false;
+	}
+
+	// Rotation between the two relative transforms.
+	const cb2Rot& q1 = m_relativeTransform.q;
+	const cb2Rot& q2 = relativeTransform.q;
+	float sinAngle = q1.c * q2.s - q1.s * q2.c;
+	float cosAngle = q1.c * q2.c + q1.s * q2.s;
+	return cosAngle > 0.0f && cb2Abs(sinAngle) <= angularTolerance;
 }
 
 // Update the contact manifold and touching status.
 // Note: do not assume the fixture AABBs are overlapping or are valid.
-void cb2Contact::Update(cb2ContactListener* listener)
+void cb2Contact::Update(cb2ContactListener* listener, float linearTolerance, float angularTolerance,
+						const cb2Manifold* manifold)
 {
 	cb2Manifold oldManifold = m_manifold;
 
@@ -182,14 +345,32 @@ void cb2Contact::Update(cb2ContactListener* listener)
 	{
 		const cb2Shape* shapeA = m_fixtureA->GetShape();
 		const cb2Shape* shapeB = m_fixtureB->GetShape();
-		touching = cb2TestOverlap(shapeA, m_indexA, shapeB, m_indexB, xfA, xfB);
+		touching = cb2TestOverlap(shapeA, m_indexA, shapeB, m_indexB, xfA, xfB, &m_simplexCache);
 
 		// Sensors don't generate manifolds.
 		m_manifold.pointCount = 0;
+		m_flags &= ~e_evaluatedFlag;
+	}
+	else if (manifold == NULL && IsReusable(cb2MulT(xfA, xfB), linearTolerance, angularTolerance))
+	{
+		// The manifold points are stored in the body frames, so the solver
+		// re-projects them with the current transforms. The impulses are kept
+		// for warm starting.
+		touching = wasTouching;
 	}
 	else
 	{
-		Evaluate(&m_manifold, xfA, xfB);
+		if (manifold)
+		{
+			m_manifold = *manifold;
+		}
+		else
+		{
+			Evaluate(&m_manifold, xfA, xfB);
+		}
+
+		m_relativeTransform = cb2MulT(xfA, xfB);
+		m_flags |= e_evaluatedFlag;
 		touching = m_manifold.pointCount > 0;
 
 		// Match old contact ids to new contact ids and copy the
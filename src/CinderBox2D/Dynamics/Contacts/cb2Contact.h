@@ -21,6 +21,7 @@
 
 #include <CinderBox2D/Common/cb2Math.h>
 #include <CinderBox2D/Collision/cb2Collision.h>
+#include <CinderBox2D/Collision/cb2Distance.h>
 #include <CinderBox2D/Collision/Shapes/cb2Shape.h>
 #include <CinderBox2D/Dynamics/cb2Fixture.h>
 
@@ -46,15 +47,32 @@ inline float cb2MixRestitution(float restitution1, float restitution2)
 	return restitution1 > restitution2 ? restitution1 : restitution2;
 }
 
-typedef cb2Contact* cb2ContactCreateFcn(	cb2Fixture* fixtureA, int indexA,
-										cb2Fixture* fixtureB, int indexB,
-										cb2BlockAllocator* allocator);
-typedef void cb2ContactDestroyFcn(cb2Contact* contact, cb2BlockAllocator* allocator);
+/// The shape pair of a contact. This selects the collision routine. Fixture A
+/// holds the first shape of the pair.
+enum cb2ContactType
+{
+	e_unknownContact,
+	e_circleContact,
+	e_polygonAndCircleContact,
+	e_polygonContact,
+	e_edgeAndCircleContact,
+	e_edgeAndPolygonContact,
+	e_chainAndCircleContact,
+	e_chainAndPolygonContact,
+	e_capsuleAndCircleContact,
+	e_capsuleContact,
+	e_polygonAndCapsuleContact,
+	e_edgeAndCapsuleContact,
+	e_chainAndCapsuleContact,
+	e_meshAndCircleContact,
+	e_meshAndPolygonContact,
+	e_meshAndCapsuleContact,
+	e_contactTypeCount
+};
 
 struct cb2ContactRegister
 {
-	cb2ContactCreateFcn* createFcn;
-	cb2ContactDestroyFcn* destroyFcn;
+	cb2ContactType type;
 	bool primary;
 };
 
@@ -74,6 +92,8 @@ struct cb2ContactEdge
 /// The class manages contact between two shapes. A contact exists for each overlapping
 /// AABB in the broad-phase (except if filtered). Therefore a contact object may exist
 /// that has no contact points.
+/// All shape pairs share this concrete type. The collision routine is picked from the
+/// contact type with a switch, so there are no virtual calls in the narrow-phase.
 class cb2Contact
 {
 public:
@@ -115,6 +135,9 @@ public:
 	/// Get the child primitive index for fixture B.
 	int GetChildIndexB() const;
 
+	/// Get the shape pair type of this contact.
+	cb2ContactType GetType() const;
+
 	/// Override the default friction mixture. You can call this in cb2ContactListener::PreSolve.
 	/// This value persists until set or reset.
 	void SetFriction(float friction);
@@ -135,6 +158,16 @@ public:
 	/// Reset the restitution to the default value.
 	void ResetRestitution();
 
+	/// Override the normal force above which this contact breaks. You can call this in
+	/// cb2ContactListener::PreSolve. The value persists until you set or reset.
+	void SetBreakForce(float force);
+
+	/// Get the break force.
+	float GetBreakForce() const;
+
+	/// Reset the break force to the lower break force of the two fixtures.
+	void ResetBreakForce();
+
 	/// Set the desired tangent speed for a conveyor belt behavior. In meters per second.
 	void SetTangentSpeed(float speed);
 
@@ -142,7 +175,7 @@ public:
 	float GetTangentSpeed() const;
 
 	/// Evaluate this contact with your own manifold and transforms.
-	virtual void Evaluate(cb2Manifold* manifold, const cb2Transform& xfA, const cb2Transform& xfB) = 0;
+	void Evaluate(cb2Manifold* manifold, const cb2Transform& xfA, const cb2Transform& xfB);
 
 protected:
 	friend class cb2ContactManager;
@@ -150,6 +183,7 @@ protected:
 	friend class cb2ContactSolver;
 	friend class cb2Body;
 	friend class cb2Fixture;
+	friend class cb2Island;
 
 	// Flags stored in m_flags
 	enum
@@ -170,30 +204,43 @@ protected:
 		e_bulletHitFlag		= 0x0010,
 
 		// This contact has a valid TOI in m_toi
-		e_toiFlag			= 0x0020
+		e_toiFlag			= 0x0020,
+
+		// m_relativeTransform holds the transforms of the last evaluation
+		e_evaluatedFlag		= 0x0040,
+
+		// Both bodies sleep in an island or are static
+		e_sleepFlag			= 0x0080
 	};
 
 	/// Flag this contact for filtering. Filtering will occur the next time step.
 	void FlagForFiltering();
 
-	static void AddType(cb2ContactCreateFcn* createFcn, cb2ContactDestroyFcn* destroyFcn,
-						cb2Shape::Type typeA, cb2Shape::Type typeB);
+	static void AddType(cb2ContactType type, cb2Shape::Type typeA, cb2Shape::Type typeB);
 	static void InitializeRegisters();
 	static cb2Contact* Create(cb2Fixture* fixtureA, int indexA, cb2Fixture* fixtureB, int indexB, cb2BlockAllocator* allocator);
-	static void Destroy(cb2Contact* contact, cb2Shape::Type typeA, cb2Shape::Type typeB, cb2BlockAllocator* allocator);
 	static void Destroy(cb2Contact* contact, cb2BlockAllocator* allocator);
 
 	cb2Contact() : m_fixtureA(NULL), m_fixtureB(NULL) {}
-	cb2Contact(cb2Fixture* fixtureA, int indexA, cb2Fixture* fixtureB, int indexB);
-	virtual ~cb2Contact() {}
+	cb2Contact(cb2Fixture* fixtureA, int indexA, cb2Fixture* fixtureB, int indexB, cb2ContactType type);
+
+	/// Update the contact manifold and touching status. The manifold is kept if the
+	/// bodies moved less than the given tolerances relative to each other since the
+	/// last evaluation. Zero tolerances always evaluate. A manifold computed ahead of
+	/// time by the contact manager replaces the evaluation; the caller only passes
+	/// one for contacts that are neither sensors nor reusable.
+	void Update(cb2ContactListener* listener, float linearTolerance = 0.0f, float angularTolerance = 0.0f,
+				const cb2Manifold* manifold = NULL);
 
-	void Update(cb2ContactListener* listener);
+	bool IsReusable(const cb2Transform& relativeTransform, float linearTolerance, float angularTolerance) const;
 
 	static cb2ContactRegister s_registers[cb2Shape::e_typeCount][cb2Shape::e_typeCount];
 	static bool s_initialized;
 
 	unsigned int m_flags;
 
+	cb2ContactType m_type;
+
 	// World pool and list pointers.
 	cb2Contact* m_prev;
 	cb2Contact* m_next;
@@ -210,13 +257,27 @@ protected:
 
 	cb2Manifold m_manifold;
 
+	// Transform of B relative to A at the last evaluation.
+	cb2Transform m_relativeTransform;
+
+	// Deepest edges of polygon contacts.
+	cb2PolygonCache m_polygonCache;
+
+	// Last GJK simplex of the pair. Warm starts sensor overlap tests and TOI.
+	cb2SimplexCache m_simplexCache;
+
 	int m_toiCount;
 	float m_toi;
 
 	float m_friction;
 	float m_restitution;
+	float m_breakForce;
 
 	float m_tangentSpeed;
+
+	// Shapes closer than this get speculative points. Set by the contact
+	// manager each step while speculative contacts are enabled.
+	float m_speculativeMargin;
 };
 
 inline cb2Manifold* cb2Contact::GetManifold()
@@ -301,6 +362,11 @@ inline int cb2Contact::GetChildIndexB() const
 	return m_indexB;
 }
 
+inline cb2ContactType cb2Contact::GetType() const
+{
+	return m_type;
+}
+
 inline void cb2Contact::FlagForFiltering()
 {
 	m_flags |= e_filterFlag;
@@ -336,6 +402,21 @@ inline void cb2Contact::ResetRestitution()
 	m_restitution = cb2MixRestitution(m_fixtureA->m_restitution, m_fixtureB->m_restitution);
 }
 
+inline void cb2Contact::SetBreakForce(float force)
+{
+	m_breakForce = force;
+}
+
+inline float cb2Contact::GetBreakForce() const
+{
+	return m_breakForce;
+}
+
+inline void cb2Contact::ResetBreakForce()
+{
+	m_breakForce = cb2Min(m_fixtureA->m_breakForce, m_fixtureB->m_breakForce);
+}
+
 inline void cb2Contact::SetTangentSpeed(float speed)
 {
 	m_tangentSpeed = speed;
@@ -51,6 +51,8 @@ cb2ContactSolver::cb2ContactSolver(cb2ContactSolverDef* def)
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
+	m_directCount = 0;
+	m_directMatrix = NULL;
 
 	// Initialize position independent portions of the constraints.
 	for (int i = 0; i < m_count; ++i)
@@ -130,6 +132,11 @@ cb2ContactSolver::cb2ContactSolver(cb2ContactSolverDef* def)
 
 cb2ContactSolver::~cb2ContactSolver()
 {
+	if (m_directMatrix)
+	{
+		m_allocator->Free(m_directMatrix);
+	}
+
 	m_allocator->Free(m_velocityConstraints);
 	m_allocator->Free(m_positionConstraints);
 }
@@ -210,6 +217,14 @@ void cb2ContactSolver::InitializeVelocityConstraints()
 			{
 				vcp->velocityBias = -vc->restitution * vRel;
 			}
+
+			// A speculative point may close its gap during the step, but no more.
+			// Keep the restitution bias when it is larger, so bounces keep their energy.
+			float separation = worldManifold.separations[j];
+			if (m_step.speculative && separation > 0.0f)
+			{
+				vcp->velocityBias = cb2Max(vcp->velocityBias, -separation * m_step.inv_dt);
+			}
 		}
 
 		// If we have two points, then prepare the block solver.
@@ -286,8 +301,18 @@ void cb2ContactSolver::WarmStart()
 	}
 }
 
-void cb2ContactSolver::SolveVelocityConstraints()
+// The change of relative velocity along a constraint row, including the rotation of
+// the bodies, made by an impulse on the row with the given effective mass.
+static inline float cb2VelocityChange(float impulse, float mass)
+{
+	return mass > 0.0f ? cb2Abs(impulse) / mass : 0.0f;
+}
+
+// Returns the largest change of relative velocity any contact row applied in the pass.
+float cb2ContactSolver::SolveVelocityConstraints()
 {
+	float maxChange = 0.0f;
+
 	for (int i = 0; i < m_count; ++i)
 	{
 		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
@@ -329,6 +354,7 @@ void cb2ContactSolver::SolveVelocityConstraints()
 			float newImpulse = cb2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
 			lambda = newImpulse - vcp->tangentImpulse;
 			vcp->tangentImpulse = newImpulse;
+			maxChange = cb2Max(maxChange, cb2VelocityChange(lambda, vcp->tangentMass));
 
 			// Apply contact impulse
 			ci::Vec2f P = lambda * tangent;
@@ -356,6 +382,7 @@ void cb2ContactSolver::SolveVelocityConstraints()
 			float newImpulse = cb2Max(vcp->normalImpulse + lambda, 0.0f);
 			lambda = newImpulse - vcp->normalImpulse;
 			vcp->normalImpulse = newImpulse;
+			maxChange = cb2Max(maxChange, cb2VelocityChange(lambda, vcp->normalMass));
 
 			// Apply contact impulse
 			ci::Vec2f P = lambda * normal;
@@ -587,13 +614,380 @@ void cb2ContactSolver::SolveVelocityConstraints()
 				// No solution, give up. This is hit sometimes, but it doesn't seem to matter.
 				break;
 			}
+
+			maxChange = cb2Max(maxChange, cb2VelocityChange(cp1->normalImpulse - a.x, cp1->normalMass));
+			maxChange = cb2Max(maxChange, cb2VelocityChange(cp2->normalImpulse - a.y, cp2->normalMass));
 		}
 
 		m_velocities[indexA].v = vA;
 		m_velocities[indexA].w = wA;
 		m_velocities[indexB].v = vB;
 		m_velocities[indexB].w = wB;
+
+	}
+
+	return maxChange;
+}
+
+// The coupling of two normal rows through the bodies they share.
+static float cb2DirectCoupling(const cb2ContactVelocityConstraint* vc1, const cb2VelocityConstraintPoint* cp1,
+							   const cb2ContactVelocityConstraint* vc2, const cb2VelocityConstraintPoint* cp2)
+{
+	float nn = cb2Dot(vc1->normal, vc2->normal);
+	float rn1A = cb2Cross(cp1->rA, vc1->normal);
+	float rn1B = cb2Cross(cp1->rB, vc1->normal);
+	float rn2A = cb2Cross(cp2->rA, vc2->normal);
+	float rn2B = cb2Cross(cp2->rB, vc2->normal);
+
+	float k = 0.0f;
+	if (vc1->indexA == vc2->indexA)
+	{
+		k += vc1->invMassA * nn + vc1->invIA * rn1A * rn2A;
+	}
+	if (vc1->indexA == vc2->indexB)
+	{
+		k -= vc1->invMassA * nn + vc1->invIA * rn1A * rn2B;
+	}
+	if (vc1->indexB == vc2->indexA)
+	{
+		k -= vc1->invMassB * nn + vc1->invIB * rn1B * rn2A;
+	}
+	if (vc1->indexB == vc2->indexB)
+	{
+		k += vc1->invMassB * nn + vc1->invIB * rn1B * rn2B;
+	}
+	return k;
+}
+
+bool cb2ContactSolver::InitializeDirectConstraints()
+{
+	int n = 0;
+	for (int i = 0; i < m_count; ++i)
+	{
+		n += m_velocityConstraints[i].pointCount;
+	}
+
+	if (n == 0 || n > cb2_maxDirectContactPoints)
+	{
+		return false;
+	}
+
+	m_directCount = n;
+	m_directMatrix = (float*)m_allocator->Allocate((2 * n * n + 3 * n) * sizeof(float) + 2 * n * sizeof(int));
+	m_directFactor = m_directMatrix + n * n;
+	m_directBias = m_directFactor + n * n;
+	m_directImpulse = m_directBias + n;
+	m_directTemp = m_directImpulse + n;
+	m_directRows = (int*)(m_directTemp + n);
+	m_directActive = m_directRows + n;
+
+	int row = 0;
+	for (int i = 0; i < m_count; ++i)
+	{
+		const cb2ContactVelocityConstraint* vc1 = m_velocityConstraints + i;
+		for (int j = 0; j < vc1->pointCount; ++j)
+		{
+			const cb2VelocityConstraintPoint* cp1 = vc1->points + j;
+
+			int column = 0;
+			for (int k = 0; k < m_count; ++k)
+			{
+				const cb2ContactVelocityConstraint* vc2 = m_velocityConstraints + k;
+				for (int l = 0; l < vc2->pointCount; ++l)
+				{
+					m_directMatrix[row * n + column] = cb2DirectCoupling(vc1, cp1, vc2, vc2->points + l);
+					++column;
+				}
+			}
+
+			// Soften the diagonal a little so that redundant points, such as a box
+			// wedged between two others, keep the matrix positive definite.
+			m_directMatrix[row * n + row] *= 1.001f;
+			++row;
+		}
+	}
+
+	return true;
+}
+
+// Solve the LCP  w = A * x + b,  x >= 0,  w >= 0,  x_i * w_i = 0  for a symmetric
+// positive definite A by principal pivoting. Each pivot solves the active rows for
+// w = 0 with a Cholesky factorization, then flips the lowest row that violates its
+// condition into or out of the active set. This least index rule (Murty) terminates
+// for positive definite matrices. The active set starts from the rows of x that are
+// positive, so warm starting usually leaves little to do. Returns false, leaving x
+// unchanged, if the factorization breaks down or the pivots run out.
+static bool cb2SolveDirectLCP(const float* A, const float* b, float* x, int n,
+							  float* L, float* y, int* rows, int* active)
+{
+	const float tolerance = 1.0e-5f;
+
+	for (int i = 0; i < n; ++i)
+	{
+		active[i] = x[i] > 0.0f;
+	}
+
+	for (int pivot = 0; pivot < 4 * n; ++pivot)
+	{
+		int k = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			if (active[i])
+			{
+				rows[k++] = i;
+			}
+		}
+
+		// Factor the active block A_SS = L * LT.
+		for (int r = 0; r < k; ++r)
+		{
+			for (int c = 0; c <= r; ++c)
+			{
+				float sum = A[rows[r] * n + rows[c]];
+				for (int m = 0; m < c; ++m)
+				{
+					sum -= L[r * k + m] * L[c * k + m];
+				}
+
+				if (r == c)
+				{
+					if (sum <= 0.0f)
+					{
+						return false;
+					}
+					L[r * k + r] = cb2Sqrt(sum);
+				}
+				else
+				{
+					L[r * k + c] = sum / L[c * k + c];
+				}
+			}
+		}
+
+		// Solve L * LT * y = -b_S.
+		for (int r = 0; r < k; ++r)
+		{
+			float sum = -b[rows[r]];
+			for (int m = 0; m < r; ++m)
+			{
+				sum -= L[r * k + m] * y[m];
+			}
+			y[r] = sum / L[r * k + r];
+		}
+
+		for (int r = k - 1; r >= 0; --r)
+		{
+			float sum = y[r];
+			for (int m = r + 1; m < k; ++m)
+			{
+				sum -= L[m * k + r] * y[m];
+			}
+			y[r] = sum / L[r * k + r];
+		}
+
+		// Find the lowest row with a negative impulse or a negative velocity.
+		int flip = -1;
+		int r = 0;
+		for (int i = 0; i < n && flip < 0; ++i)
+		{
+			if (active[i])
+			{
+				if (y[r] < 0.0f)
+				{
+					flip = i;
+				}
+				++r;
+			}
+			else
+			{
+				float w = b[i];
+				for (int m = 0; m < k; ++m)
+				{
+					w += A[i * n + rows[m]] * y[m];
+				}
+
+				if (w < -tolerance)
+				{
+					flip = i;
+				}
+			}
+		}
+
+		if (flip < 0)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				x[i] = 0.0f;
+			}
+
+			for (int m = 0; m < k; ++m)
+			{
+				x[rows[m]] = y[m];
+			}
+
+			return true;
+		}
+
+		active[flip] = !active[flip];
 	}
+
+	return false;
+}
+
+float cb2ContactSolver::SolveDirectVelocityConstraints()
+{
+	cb2Assert(m_directMatrix != NULL);
+
+	float maxChange = 0.0f;
+
+	// Solve friction point by point against the current normal impulses.
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+
+		int indexA = vc->indexA;
+		int indexB = vc->indexB;
+		float mA = vc->invMassA;
+		float iA = vc->invIA;
+		float mB = vc->invMassB;
+		float iB = vc->invIB;
+
+		ci::Vec2f vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		ci::Vec2f vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
+
+		ci::Vec2f tangent = cb2Cross(vc->normal, 1.0f);
+
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			ci::Vec2f dv = vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA);
+
+			float vt = cb2Dot(dv, tangent) - vc->tangentSpeed;
+			float lambda = vcp->tangentMass * (-vt);
+
+			float maxFriction = vc->friction * vcp->normalImpulse;
+			float newImpulse = cb2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
+			lambda = newImpulse - vcp->tangentImpulse;
+			vcp->tangentImpulse = newImpulse;
+			maxChange = cb2Max(maxChange, cb2VelocityChange(lambda, vcp->tangentMass));
+
+			ci::Vec2f P = lambda * tangent;
+
+			vA -= mA * P;
+			wA -= iA * cb2Cross(vcp->rA, P);
+
+			vB += mB * P;
+			wB += iB * cb2Cross(vcp->rB, P);
+		}
+
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
+
+	}
+
+	// Gather the normal velocities and the accumulated impulses. As in the block
+	// solver, the LCP is written for the new total impulse x with b' = b - A * a.
+	int n = m_directCount;
+	float* A = m_directMatrix;
+	float* b = m_directBias;
+	float* x = m_directImpulse;
+
+	int row = 0;
+	for (int i = 0; i < m_count; ++i)
+	{
+		const cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+
+		ci::Vec2f vA = m_velocities[vc->indexA].v;
+		float wA = m_velocities[vc->indexA].w;
+		ci::Vec2f vB = m_velocities[vc->indexB].v;
+		float wB = m_velocities[vc->indexB].w;
+
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			const cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			ci::Vec2f dv = vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA);
+			b[row] = cb2Dot(dv, vc->normal) - vcp->velocityBias;
+			x[row] = vcp->normalImpulse;
+			++row;
+		}
+	}
+
+	for (int r = 0; r < n; ++r)
+	{
+		for (int c = 0; c < n; ++c)
+		{
+			b[r] -= A[r * n + c] * x[c];
+		}
+	}
+
+	if (cb2SolveDirectLCP(A, b, x, n, m_directFactor, m_directTemp, m_directRows, m_directActive) == false)
+	{
+		// Fall back to projected Gauss-Seidel sweeps on the matrix, which need no
+		// body access and are cheap at this size.
+		for (int sweep = 0; sweep < n; ++sweep)
+		{
+			for (int r = 0; r < n; ++r)
+			{
+				float w = b[r];
+				for (int c = 0; c < n; ++c)
+				{
+					w += A[r * n + c] * x[c];
+				}
+				x[r] = cb2Max(x[r] - w / A[r * n + r], 0.0f);
+			}
+		}
+	}
+
+	// Apply the change of the impulses.
+	row = 0;
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+
+		int indexA = vc->indexA;
+		int indexB = vc->indexB;
+		float mA = vc->invMassA;
+		float iA = vc->invIA;
+		float mB = vc->invMassB;
+		float iB = vc->invIB;
+
+		ci::Vec2f vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		ci::Vec2f vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
+
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			float lambda = x[row] - vcp->normalImpulse;
+			vcp->normalImpulse = x[row];
+			maxChange = cb2Max(maxChange, cb2VelocityChange(lambda, vcp->normalMass));
+			++row;
+
+			ci::Vec2f P = lambda * vc->normal;
+
+			vA -= mA * P;
+			wA -= iA * cb2Cross(vcp->rA, P);
+
+			vB += mB * P;
+			wB += iB * cb2Cross(vcp->rB, P);
+		}
+
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
+
+	}
+
+	return maxChange;
 }
 
 void cb2ContactSolver::StoreImpulses()
@@ -611,6 +1005,293 @@ void cb2ContactSolver::StoreImpulses()
 	}
 }
 
+// Spring-damper coefficients for a constraint solved with time step h.
+static cb2Softness cb2MakeSoftness(float hertz, float dampingRatio, float h)
+{
+	float omega = 2.0f * cb2_pi * hertz;
+	float a1 = 2.0f * dampingRatio + h * omega;
+	float a2 = h * omega * a1;
+	float a3 = 1.0f / (1.0f + a2);
+
+	cb2Softness softness;
+	softness.biasRate = omega / a1;
+	softness.massScale = a2 * a3;
+	softness.impulseScale = a3;
+	return softness;
+}
+
+// Initialize the constraints of the soft step solver. Unlike the classic solver the
+// anchors stay fixed over the step and both points of a manifold are solved one by one.
+// The separation of a point is tracked from the motion of the bodies in each sub-step.
+void cb2ContactSolver::InitializeSoftConstraints()
+{
+	// Contact softness. The spring must be resolved by the sub-step.
+	float contactHertz = cb2Min(cb2_contactHertz, 0.25f * m_step.inv_dt);
+	m_softness = cb2MakeSoftness(contactHertz, cb2_contactDampingRatio, m_step.dt);
+	m_staticSoftness = cb2MakeSoftness(2.0f * contactHertz, cb2_contactDampingRatio, m_step.dt);
+
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		cb2ContactPositionConstraint* pc = m_positionConstraints + i;
+
+		float radiusA = pc->radiusA;
+		float radiusB = pc->radiusB;
+		cb2Manifold* manifold = m_contacts[vc->contactIndex]->GetManifold();
+
+		int indexA = vc->indexA;
+		int indexB = vc->indexB;
+
+		float mA = vc->invMassA;
+		float mB = vc->invMassB;
+		float iA = vc->invIA;
+		float iB = vc->invIB;
+
+		ci::Vec2f cA = m_positions[indexA].c;
+		float aA = m_positions[indexA].a;
+		ci::Vec2f vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+
+		ci::Vec2f cB = m_positions[indexB].c;
+		float aB = m_positions[indexB].a;
+		ci::Vec2f vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
+
+		cb2Transform xfA, xfB;
+		xfA.q.set(aA);
+		xfB.q.set(aB);
+		xfA.p = cA - cb2Mul(xfA.q, pc->localCenterA);
+		xfB.p = cB - cb2Mul(xfB.q, pc->localCenterB);
+
+		cb2WorldManifold worldManifold;
+		worldManifold.Initialize(manifold, xfA, radiusA, xfB, radiusB);
+
+		vc->normal = worldManifold.normal;
+		vc->angleA = aA;
+		vc->angleB = aB;
+
+		ci::Vec2f tangent = cb2Cross(vc->normal, 1.0f);
+		float offset = cb2Dot(cB - cA, vc->normal);
+
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			vcp->rA = worldManifold.points[j] - cA;
+			vcp->rB = worldManifold.points[j] - cB;
+
+			float rnA = cb2Cross(vcp->rA, vc->normal);
+			float rnB = cb2Cross(vcp->rB, vc->normal);
+			float kNormal = mA + mB + iA * rnA * rnA + iB * rnB * rnB;
+			vcp->normalMass = kNormal > 0.0f ? 1.0f / kNormal : 0.0f;
+
+			float rtA = cb2Cross(vcp->rA, tangent);
+			float rtB = cb2Cross(vcp->rB, tangent);
+			float kTangent = mA + mB + iA * rtA * rtA + iB * rtB * rtB;
+			vcp->tangentMass = kTangent > 0.0f ? 1.0f / kTangent : 0.0f;
+
+			vcp->velocityBias = 0.0f;
+			vcp->adjustedSeparation = worldManifold.separations[j] - offset;
+			vcp->relativeVelocity = cb2Dot(vc->normal, vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA));
+			vcp->maxNormalImpulse = 0.0f;
+			vcp->restitutionImpulse = 0.0f;
+		}
+	}
+}
+
+// One sub-step pass over the soft constraints. With the bias, overlap is pushed out by
+// the contact spring. Without it, the pass relaxes the velocity the push out added.
+// Separated points only let the shapes close their gap in the sub-step.
+void cb2ContactSolver::SolveSoftVelocityConstraints(bool useBias)
+{
+	float inv_h = m_step.inv_dt;
+
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+
+		int indexA = vc->indexA;
+		int indexB = vc->indexB;
+		float mA = vc->invMassA;
+		float iA = vc->invIA;
+		float mB = vc->invMassB;
+		float iB = vc->invIB;
+		int pointCount = vc->pointCount;
+
+		ci::Vec2f vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		ci::Vec2f vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
+
+		// Body motion since initialization. Anchors are rotated to first order.
+		ci::Vec2f dc = m_positions[indexB].c - m_positions[indexA].c;
+		float daA = m_positions[indexA].a - vc->angleA;
+		float daB = m_positions[indexB].a - vc->angleB;
+
+		ci::Vec2f normal = vc->normal;
+		ci::Vec2f tangent = cb2Cross(normal, 1.0f);
+		float friction = vc->friction;
+
+		const cb2Softness& softness = (mA == 0.0f || mB == 0.0f) ? m_staticSoftness : m_softness;
+
+		// Solve normal constraints first so that friction is bounded by the current
+		// normal impulse.
+		for (int j = 0; j < pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			// Current separation
+			ci::Vec2f d = dc + cb2Cross(daB, vcp->rB) - cb2Cross(daA, vcp->rA);
+			float s = cb2Dot(d, normal) + vcp->adjustedSeparation;
+
+			float bias = 0.0f;
+			float massScale = 1.0f;
+			float impulseScale = 0.0f;
+			if (s > 0.0f)
+			{
+				// Speculative
+				bias = s * inv_h;
+			}
+			else if (useBias)
+			{
+				bias = cb2Max(softness.biasRate * cb2Min(s + cb2_linearSlop, 0.0f), -cb2_contactPushVelocity);
+				massScale = softness.massScale;
+				impulseScale = softness.impulseScale;
+			}
+
+			ci::Vec2f dv = vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA);
+			float vn = cb2Dot(dv, normal);
+
+			float lambda = -vcp->normalMass * massScale * (vn + bias) - impulseScale * vcp->normalImpulse;
+
+			float newImpulse = cb2Max(vcp->normalImpulse + lambda, 0.0f);
+			lambda = newImpulse - vcp->normalImpulse;
+			vcp->normalImpulse = newImpulse;
+			vcp->maxNormalImpulse = cb2Max(vcp->maxNormalImpulse, lambda);
+
+			ci::Vec2f P = lambda * normal;
+
+			vA -= mA * P;
+			wA -= iA * cb2Cross(vcp->rA, P);
+
+			vB += mB * P;
+			wB += iB * cb2Cross(vcp->rB, P);
+		}
+
+		for (int j = 0; j < pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			ci::Vec2f dv = vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA);
+
+			float vt = cb2Dot(dv, tangent) - vc->tangentSpeed;
+			float lambda = vcp->tangentMass * (-vt);
+
+			float maxFriction = friction * vcp->normalImpulse;
+			float newImpulse = cb2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
+			lambda = newImpulse - vcp->tangentImpulse;
+			vcp->tangentImpulse = newImpulse;
+
+			ci::Vec2f P = lambda * tangent;
+
+			vA -= mA * P;
+			wA -= iA * cb2Cross(vcp->rA, P);
+
+			vB += mB * P;
+			wB += iB * cb2Cross(vcp->rB, P);
+		}
+
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
+	}
+}
+
+// Bounce the points that approached faster than the threshold and were pushed apart
+// during the step. This runs once after the last sub-step.
+void cb2ContactSolver::ApplyRestitution()
+{
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+
+		float restitution = vc->restitution;
+		if (restitution == 0.0f)
+		{
+			continue;
+		}
+
+		int indexA = vc->indexA;
+		int indexB = vc->indexB;
+		float mA = vc->invMassA;
+		float iA = vc->invIA;
+		float mB = vc->invMassB;
+		float iB = vc->invIB;
+		int pointCount = vc->pointCount;
+
+		ci::Vec2f vA = m_velocities[indexA].v;
+		float wA = m_velocities[indexA].w;
+		ci::Vec2f vB = m_velocities[indexB].v;
+		float wB = m_velocities[indexB].w;
+
+		ci::Vec2f normal = vc->normal;
+
+		for (int j = 0; j < pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+
+			if (vcp->relativeVelocity > -cb2_velocityThreshold || vcp->maxNormalImpulse == 0.0f)
+			{
+				continue;
+			}
+
+			ci::Vec2f dv = vB + cb2Cross(wB, vcp->rB) - vA - cb2Cross(wA, vcp->rA);
+			float vn = cb2Dot(dv, normal);
+
+			float lambda = -vcp->normalMass * (vn + restitution * vcp->relativeVelocity);
+
+			float newImpulse = cb2Max(vcp->normalImpulse + lambda, 0.0f);
+			lambda = newImpulse - vcp->normalImpulse;
+			vcp->normalImpulse = newImpulse;
+			vcp->maxNormalImpulse = cb2Max(vcp->maxNormalImpulse, lambda);
+			vcp->restitutionImpulse += lambda;
+
+			ci::Vec2f P = lambda * normal;
+
+			vA -= mA * P;
+			wA -= iA * cb2Cross(vcp->rA, P);
+
+			vB += mB * P;
+			wB += iB * cb2Cross(vcp->rB, P);
+		}
+
+		m_velocities[indexA].v = vA;
+		m_velocities[indexA].w = wA;
+		m_velocities[indexB].v = vB;
+		m_velocities[indexB].w = wB;
+	}
+}
+
+// Scale the impulses of the last sub-step to the whole step, so they are stored and
+// reported like the impulses of the classic solver. Restitution is applied once per
+// step and is not scaled. Warm starting from the last sub-step is more stable than
+// from the sum of the sub-steps, which averages out the final contact state.
+void cb2ContactSolver::FinishSoftImpulses(int subStepCount)
+{
+	for (int i = 0; i < m_count; ++i)
+	{
+		cb2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			cb2VelocityConstraintPoint* vcp = vc->points + j;
+			float subStepImpulse = vcp->normalImpulse - vcp->restitutionImpulse;
+			vcp->normalImpulse = subStepCount * subStepImpulse + vcp->restitutionImpulse;
+			vcp->tangentImpulse *= subStepCount;
+		}
+	}
+}
+
 struct cb2PositionSolverManifold
 {
 	void Initialize(cb2ContactPositionConstraint* pc, const cb2Transform& xfA, const cb2Transform& xfB, int index)
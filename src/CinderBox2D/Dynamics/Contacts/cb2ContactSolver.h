@@ -37,6 +37,10 @@ struct cb2VelocityConstraintPoint
 	float normalMass;
 	float tangentMass;
 	float velocityBias;
+	float adjustedSeparation;	// soft step: separation less the initial center offset
+	float relativeVelocity;	// soft step: approach velocity for restitution
+	float maxNormalImpulse;	// soft step: largest normal impulse of any sub-step
+	float restitutionImpulse;	// soft step: normal impulse added by restitution
 };
 
 struct cb2ContactVelocityConstraint
@@ -52,10 +56,19 @@ struct cb2ContactVelocityConstraint
 	float friction;
 	float restitution;
 	float tangentSpeed;
+	float angleA, angleB;	// soft step: body angles at initialization
 	int pointCount;
 	int contactIndex;
 };
 
+/// Coefficients of a soft constraint for one sub-step.
+struct cb2Softness
+{
+	float biasRate;
+	float massScale;
+	float impulseScale;
+};
+
 struct cb2ContactSolverDef
 {
 	cb2TimeStep step;
@@ -75,12 +88,24 @@ public:
 	void InitializeVelocityConstraints();
 
 	void WarmStart();
-	void SolveVelocityConstraints();
+	float SolveVelocityConstraints();
 	void StoreImpulses();
 
+	/// Direct solver. The normal impulses of all points are solved together as one LCP.
+	/// Initialization fails for more than cb2_maxDirectContactPoints points, and the
+	/// iterative solver must be used instead.
+	bool InitializeDirectConstraints();
+	float SolveDirectVelocityConstraints();
+
 	bool SolvePositionConstraints();
 	bool SolveTOIPositionConstraints(int toiIndexA, int toiIndexB);
 
+	/// Soft step solver. The step of the solver definition is the sub-step.
+	void InitializeSoftConstraints();
+	void SolveSoftVelocityConstraints(bool useBias);
+	void ApplyRestitution();
+	void FinishSoftImpulses(int subStepCount);
+
 	cb2TimeStep m_step;
 	cb2Position* m_positions;
 	cb2Velocity* m_velocities;
@@ -89,6 +114,21 @@ public:
 	cb2ContactVelocityConstraint* m_velocityConstraints;
 	cb2Contact** m_contacts;
 	int m_count;
+
+	// Soft contact coefficients of the sub-step. Contacts with a static or
+	// kinematic body are stiffer since all of the mass is on one side.
+	cb2Softness m_softness;
+	cb2Softness m_staticSoftness;
+
+	// Direct solver workspace. The rows are the points of all constraints in order.
+	int m_directCount;
+	float* m_directMatrix;	// J * invM * JT, row major
+	float* m_directFactor;	// Cholesky factor of the active rows
+	float* m_directBias;
+	float* m_directImpulse;
+	float* m_directTemp;
+	int* m_directRows;		// the active rows
+	int* m_directActive;	// is a row active?
 };
 
 #endif
@@ -257,5 +257,6 @@ void cb2DistanceJoint::Dump()
 	cb2Log("  jd.length = %.15lef;\n", m_length);
 	cb2Log("  jd.frequencyHz = %.15lef;\n", m_frequencyHz);
 	cb2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
@@ -247,5 +247,6 @@ void cb2FrictionJoint::Dump()
 	cb2Log("  jd.localAnchorB.set(%.15lef, %.15lef);\n", m_localAnchorB.x, m_localAnchorB.y);
 	cb2Log("  jd.maxForce = %.15lef;\n", m_maxForce);
 	cb2Log("  jd.maxTorque = %.15lef;\n", m_maxTorque);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
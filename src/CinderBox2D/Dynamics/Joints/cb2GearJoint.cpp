@@ -413,5 +413,6 @@ void cb2GearJoint::Dump()
 	cb2Log("  jd.joint1 = joints[%d];\n", index1);
 	cb2Log("  jd.joint2 = joints[%d];\n", index2);
 	cb2Log("  jd.ratio = %.15lef;\n", m_ratio);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
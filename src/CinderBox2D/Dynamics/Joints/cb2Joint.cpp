@@ -180,6 +180,251 @@ void cb2Joint::Destroy(cb2Joint* joint, cb2BlockAllocator* allocator)
 	}
 }
 
+void cb2Joint::DumpBreakLimits() const
+{
+	if (m_breakForce < cb2_maxFloat)
+	{
+		cb2Log("  jd.breakForce = %.15lef;\n", m_breakForce);
+	}
+
+	if (m_breakTorque < cb2_maxFloat)
+	{
+		cb2Log("  jd.breakTorque = %.15lef;\n", m_breakTorque);
+	}
+}
+
+template <typename T>
+void cb2Joint::GetReactionOf(const cb2Joint* joint, cb2JointReaction* reaction)
+{
+	const T* typed = (const T*)joint;
+	reaction->linearImpulse = typed->T::GetReactionForce(1.0f);
+	reaction->angularImpulse = typed->T::GetReactionTorque(1.0f);
+}
+
+void cb2Joint::GetReaction(cb2JointReaction* reaction) const
+{
+	reaction->joint = (cb2Joint*)this;
+
+	switch (m_type)
+	{
+	case e_revoluteJoint:
+		GetReactionOf<cb2RevoluteJoint>(this, reaction);
+		break;
+
+	case e_prismaticJoint:
+		GetReactionOf<cb2PrismaticJoint>(this, reaction);
+		break;
+
+	case e_distanceJoint:
+		GetReactionOf<cb2DistanceJoint>(this, reaction);
+		break;
+
+	case e_pulleyJoint:
+		GetReactionOf<cb2PulleyJoint>(this, reaction);
+		break;
+
+	case e_mouseJoint:
+		GetReactionOf<cb2MouseJoint>(this, reaction);
+		break;
+
+	case e_gearJoint:
+		GetReactionOf<cb2GearJoint>(this, reaction);
+		break;
+
+	case e_wheelJoint:
+		GetReactionOf<cb2WheelJoint>(this, reaction);
+		break;
+
+	case e_weldJoint:
+		GetReactionOf<cb2WeldJoint>(this, reaction);
+		break;
+
+	case e_frictionJoint:
+		GetReactionOf<cb2FrictionJoint>(this, reaction);
+		break;
+
+	case e_ropeJoint:
+		GetReactionOf<cb2RopeJoint>(this, reaction);
+		break;
+
+	case e_motorJoint:
+		GetReactionOf<cb2MotorJoint>(this, reaction);
+		break;
+
+	default:
+		cb2Assert(false);
+		break;
+	}
+}
+
+void cb2Joint::GetImpulses(cb2JointImpulse* impulses) const
+{
+	cb2::setZero(impulses->impulse);
+	impulses->motorImpulse = 0.0f;
+	impulses->springImpulse = 0.0f;
+	impulses->limitState = e_inactiveLimit;
+
+	switch (m_type)
+	{
+	case e_revoluteJoint:
+		{
+			const cb2RevoluteJoint* joint = (const cb2RevoluteJoint*)this;
+			impulses->impulse = joint->m_impulse;
+			impulses->motorImpulse = joint->m_motorImpulse;
+			impulses->limitState = joint->m_limitState;
+		}
+		break;
+
+	case e_prismaticJoint:
+		{
+			const cb2PrismaticJoint* joint = (const cb2PrismaticJoint*)this;
+			impulses->impulse = joint->m_impulse;
+			impulses->motorImpulse = joint->m_motorImpulse;
+			impulses->limitState = joint->m_limitState;
+		}
+		break;
+
+	case e_distanceJoint:
+		impulses->impulse.x = ((const cb2DistanceJoint*)this)->m_impulse;
+		break;
+
+	case e_pulleyJoint:
+		impulses->impulse.x = ((const cb2PulleyJoint*)this)->m_impulse;
+		break;
+
+	case e_mouseJoint:
+		{
+			const cb2MouseJoint* joint = (const cb2MouseJoint*)this;
+			impulses->impulse = ci::Vec3f(joint->m_impulse.x, joint->m_impulse.y, 0.0f);
+		}
+		break;
+
+	case e_gearJoint:
+		impulses->impulse.x = ((const cb2GearJoint*)this)->m_impulse;
+		break;
+
+	case e_wheelJoint:
+		{
+			const cb2WheelJoint* joint = (const cb2WheelJoint*)this;
+			impulses->impulse.x = joint->m_impulse;
+			impulses->motorImpulse = joint->m_motorImpulse;
+			impulses->springImpulse = joint->m_springImpulse;
+		}
+		break;
+
+	case e_weldJoint:
+		impulses->impulse = ((const cb2WeldJoint*)this)->m_impulse;
+		break;
+
+	case e_frictionJoint:
+		{
+			const cb2FrictionJoint* joint = (const cb2FrictionJoint*)this;
+			impulses->impulse = ci::Vec3f(joint->m_linearImpulse.x, joint->m_linearImpulse.y, joint->m_angularImpulse);
+		}
+		break;
+
+	case e_ropeJoint:
+		{
+			const cb2RopeJoint* joint = (const cb2RopeJoint*)this;
+			impulses->impulse.x = joint->m_impulse;
+			impulses->limitState = joint->m_state;
+		}
+		break;
+
+	case e_motorJoint:
+		{
+			const cb2MotorJoint* joint = (const cb2MotorJoint*)this;
+			impulses->impulse = ci::Vec3f(joint->m_linearImpulse.x, joint->m_linearImpulse.y, joint->m_angularImpulse);
+		}
+		break;
+
+	default:
+		cb2Assert(false);
+		break;
+	}
+}
+
+void cb2Joint::SetImpulses(const cb2JointImpulse& impulses)
+{
+	switch (m_type)
+	{
+	case e_revoluteJoint:
+		{
+			cb2RevoluteJoint* joint = (cb2RevoluteJoint*)this;
+			joint->m_impulse = impulses.impulse;
+			joint->m_motorImpulse = impulses.motorImpulse;
+			joint->m_limitState = impulses.limitState;
+		}
+		break;
+
+	case e_prismaticJoint:
+		{
+			cb2PrismaticJoint* joint = (cb2PrismaticJoint*)this;
+			joint->m_impulse = impulses.impulse;
+			joint->m_motorImpulse = impulses.motorImpulse;
+			joint->m_limitState = impulses.limitState;
+		}
+		break;
+
+	case e_distanceJoint:
+		((cb2DistanceJoint*)this)->m_impulse = impulses.impulse.x;
+		break;
+
+	case e_pulleyJoint:
+		((cb2PulleyJoint*)this)->m_impulse = impulses.impulse.x;
+		break;
+
+	case e_mouseJoint:
+		((cb2MouseJoint*)this)->m_impulse = ci::Vec2f(impulses.impulse.x, impulses.impulse.y);
+		break;
+
+	case e_gearJoint:
+		((cb2GearJoint*)this)->m_impulse = impulses.impulse.x;
+		break;
+
+	case e_wheelJoint:
+		{
+			cb2WheelJoint* joint = (cb2WheelJoint*)this;
+			joint->m_impulse = impulses.impulse.x;
+			joint->m_motorImpulse = impulses.motorImpulse;
+			joint->m_springImpulse = impulses.springImpulse;
+		}
+		break;
+
+	case e_weldJoint:
+		((cb2WeldJoint*)this)->m_impulse = impulses.impulse;
+		break;
+
+	case e_frictionJoint:
+		{
+			cb2FrictionJoint* joint = (cb2FrictionJoint*)this;
+			joint->m_linearImpulse = ci::Vec2f(impulses.impulse.x, impulses.impulse.y);
+			joint->m_angularImpulse = impulses.impulse.z;
+		}
+		break;
+
+	case e_ropeJoint:
+		{
+			cb2RopeJoint* joint = (cb2RopeJoint*)this;
+			joint->m_impulse = impulses.impulse.x;
+			joint->m_state = impulses.limitState;
+		}
+		break;
+
+	case e_motorJoint:
+		{
+			cb2MotorJoint* joint = (cb2MotorJoint*)this;
+			joint->m_linearImpulse = ci::Vec2f(impulses.impulse.x, impulses.impulse.y);
+			joint->m_angularImpulse = impulses.impulse.z;
+		}
+		break;
+
+	default:
+		cb2Assert(false);
+		break;
+	}
+}
+
 cb2Joint::cb2Joint(const cb2JointDef* def)
 {
 	cb2Assert(def->bodyA != def->bodyB);
@@ -192,8 +437,13 @@ cb2Joint::cb2Joint(const cb2JointDef* def)
 	m_index = 0;
 	m_collideConnected = def->collideConnected;
 	m_islandFlag = false;
+	m_broken = false;
 	m_userData = def->userData;
 
+	cb2Assert(def->breakForce >= 0.0f && def->breakTorque >= 0.0f);
+	m_breakForce = def->breakForce;
+	m_breakTorque = def->breakTorque;
+
 	m_edgeA.joint = NULL;
 	m_edgeA.other = NULL;
 	m_edgeA.prev = NULL;
@@ -57,6 +57,28 @@ struct cb2Jacobian
 	float angularB;
 };
 
+/// A copy of the accumulated impulses a joint uses to warm start the solver. Joints
+/// keep their impulses in their own members. This structure only carries them in and
+/// out through GetImpulses and SetImpulses. The values are in the constraint frame of
+/// the joint type, for example the point impulse in x and y and the angular impulse in
+/// z for a weld joint. Unused fields are zero.
+struct cb2JointImpulse
+{
+	ci::Vec3f impulse;				///< the constraint impulse
+	float motorImpulse;				///< the motor impulse (revolute, prismatic, wheel)
+	float springImpulse;			///< the spring impulse (wheel)
+	cb2LimitState limitState;		///< the limit state the impulses belong to
+};
+
+/// The reaction a joint applied to bodyB over the last step, in world coordinates.
+/// Multiply by the inverse time step to get the force and torque.
+struct cb2JointReaction
+{
+	cb2Joint* joint;				///< the joint
+	ci::Vec2f linearImpulse;		///< the reaction impulse
+	float angularImpulse;			///< the reaction angular impulse
+};
+
 /// A joint edge is used to connect bodies and joints together
 /// in a joint graph where each body is a node and each joint
 /// is an edge. A joint edge belongs to a doubly linked list
@@ -80,6 +102,8 @@ struct cb2JointDef
 		bodyA = NULL;
 		bodyB = NULL;
 		collideConnected = false;
+		breakForce = cb2_maxFloat;
+		breakTorque = cb2_maxFloat;
 	}
 
 	/// The joint type is set automatically for concrete joint types.
@@ -96,6 +120,12 @@ struct cb2JointDef
 
 	/// set this flag to true if the attached bodies should collide.
 	bool collideConnected;
+
+	/// The joint breaks when its reaction force exceeds this, in Newtons.
+	float breakForce;
+
+	/// The joint breaks when its reaction torque exceeds this, in N*m.
+	float breakTorque;
 };
 
 /// The base joint class. Joints are used to constraint two bodies together in
@@ -125,6 +155,17 @@ public:
 	/// Get the reaction torque on bodyB in N*m.
 	virtual float GetReactionTorque(float inv_dt) const = 0;
 
+	/// Get the reaction impulses on bodyB from the last step. This does not need the
+	/// time step and does not go through the vtable, so it is cheap to call for many joints.
+	/// @see cb2World::GetJointReactions
+	void GetReaction(cb2JointReaction* reaction) const;
+
+	/// Get the accumulated impulses, for example to keep them while the joint is rebuilt.
+	void GetImpulses(cb2JointImpulse* impulses) const;
+
+	/// Set the accumulated impulses. They warm start the next step if warm starting is on.
+	void SetImpulses(const cb2JointImpulse& impulses);
+
 	/// Get the next joint the world joint list.
 	cb2Joint* GetNext();
 	const cb2Joint* GetNext() const;
@@ -143,6 +184,23 @@ public:
 	/// the flag is only checked when fixture AABBs begin to overlap.
 	bool GetCollideConnected() const;
 
+	/// Get the reaction force above which the joint breaks.
+	float GetBreakForce() const;
+
+	/// Set the reaction force above which the joint breaks.
+	void SetBreakForce(float force);
+
+	/// Get the reaction torque above which the joint breaks.
+	float GetBreakTorque() const;
+
+	/// Set the reaction torque above which the joint breaks.
+	void SetBreakTorque(float torque);
+
+	/// Has the joint broken? A broken joint no longer constrains its bodies. It stays
+	/// in the world until you destroy it.
+	/// @see cb2World::GetJointBreaks
+	bool IsBroken() const;
+
 	/// Dump this joint to the log file.
 	virtual void Dump() { cb2Log("// Dump is not supported for this joint type.\n"); }
 
@@ -167,6 +225,12 @@ protected:
 	// This returns true if the position errors are within tolerance.
 	virtual bool SolvePositionConstraints(const cb2SolverData& data) = 0;
 
+	// Log the break thresholds that are set. Called by the Dump of each joint type.
+	void DumpBreakLimits() const;
+
+	template <typename T>
+	static void GetReactionOf(const cb2Joint* joint, cb2JointReaction* reaction);
+
 	cb2JointType m_type;
 	cb2Joint* m_prev;
 	cb2Joint* m_next;
@@ -179,6 +243,10 @@ protected:
 
 	bool m_islandFlag;
 	bool m_collideConnected;
+	bool m_broken;
+
+	float m_breakForce;
+	float m_breakTorque;
 
 	void* m_userData;
 };
@@ -223,4 +291,31 @@ inline bool cb2Joint::GetCollideConnected() const
 	return m_collideConnected;
 }
 
+inline float cb2Joint::GetBreakForce() const
+{
+	return m_breakForce;
+}
+
+inline void cb2Joint::SetBreakForce(float force)
+{
+	cb2Assert(force >= 0.0f);
+	m_breakForce = force;
+}
+
+inline float cb2Joint::GetBreakTorque() const
+{
+	return m_breakTorque;
+}
+
+inline void cb2Joint::SetBreakTorque(float torque)
+{
+	cb2Assert(torque >= 0.0f);
+	m_breakTorque = torque;
+}
+
+inline bool cb2Joint::IsBroken() const
+{
+	return m_broken;
+}
+
 #endif
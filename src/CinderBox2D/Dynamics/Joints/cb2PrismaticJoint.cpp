@@ -616,5 +616,6 @@ void cb2PrismaticJoint::Dump()
 	cb2Log("  jd.enableMotor = bool(%d);\n", m_enableMotor);
 	cb2Log("  jd.motorSpeed = %.15lef;\n", m_motorSpeed);
 	cb2Log("  jd.maxMotorForce = %.15lef;\n", m_maxMotorForce);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
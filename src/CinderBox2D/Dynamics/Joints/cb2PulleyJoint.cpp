@@ -338,6 +338,7 @@ void cb2PulleyJoint::Dump()
 	cb2Log("  jd.lengthA = %.15lef;\n", m_lengthA);
 	cb2Log("  jd.lengthB = %.15lef;\n", m_lengthB);
 	cb2Log("  jd.ratio = %.15lef;\n", m_ratio);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
 
@@ -499,5 +499,6 @@ void cb2RevoluteJoint::Dump()
 	cb2Log("  jd.enableMotor = bool(%d);\n", m_enableMotor);
 	cb2Log("  jd.motorSpeed = %.15lef;\n", m_motorSpeed);
 	cb2Log("  jd.maxMotorTorque = %.15lef;\n", m_maxMotorTorque);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
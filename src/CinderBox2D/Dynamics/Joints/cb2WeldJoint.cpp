@@ -324,5 +324,6 @@ void cb2WeldJoint::Dump()
 	cb2Log("  jd.referenceAngle = %.15lef;\n", m_referenceAngle);
 	cb2Log("  jd.frequencyHz = %.15lef;\n", m_frequencyHz);
 	cb2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
@@ -415,5 +415,6 @@ void cb2WheelJoint::Dump()
 	cb2Log("  jd.maxMotorTorque = %.15lef;\n", m_maxMotorTorque);
 	cb2Log("  jd.frequencyHz = %.15lef;\n", m_frequencyHz);
 	cb2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
+	DumpBreakLimits();
 	cb2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
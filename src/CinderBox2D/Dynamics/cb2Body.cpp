@@ -70,6 +70,13 @@ cb2Body::cb2Body(const cb2BodyDef* bd, cb2World* world)
 	m_prev = NULL;
 	m_next = NULL;
 
+	m_compound = NULL;
+	m_compoundNext = NULL;
+	m_compoundTransform.SetIdentity();
+	m_compoundList = NULL;
+
+	m_sleepNext = NULL;
+
 	m_linearVelocity = bd->linearVelocity;
 	m_angularVelocity = bd->angularVelocity;
 
@@ -219,6 +226,10 @@ void cb2Body::DestroyFixture(cb2Fixture* fixture)
 
 	cb2Assert(fixture->m_body == this);
 
+	// A merged body is inactive and its fixtures are copied onto the compound, so they
+	// are destroyed by unmerging it first.
+	cb2Assert(m_compound == NULL);
+
 	// Remove the fixture from this body's singly linked list.
 	cb2Assert(m_fixtureCount > 0);
 	cb2Fixture** node = &m_fixtureList;
@@ -402,7 +413,7 @@ bool cb2Body::ShouldCollide(const cb2Body* other) const
 	{
 		if (jn->other == other)
 		{
-			if (jn->joint->m_collideConnected == false)
+			if (jn->joint->m_collideConnected == false && jn->joint->m_broken == false)
 			{
 				return false;
 			}
@@ -434,6 +445,8 @@ void cb2Body::SetTransform(const ci::Vec2f& position, float angle)
 	{
 		f->Synchronize(broadPhase, m_xf, m_xf);
 	}
+
+	SynchronizeCompound();
 }
 
 void cb2Body::SetPosition(ci::Vec2f& position)
@@ -453,6 +466,8 @@ void cb2Body::SetPosition(ci::Vec2f& position)
 	{
 		f->Synchronize(broadPhase, m_xf, m_xf);
 	}
+
+	SynchronizeCompound();
 }
 
 void cb2Body::SynchronizeFixtures()
@@ -466,6 +481,43 @@ void cb2Body::SynchronizeFixtures()
 	{
 		f->Synchronize(broadPhase, xf1, m_xf);
 	}
+
+	SynchronizeCompound();
+}
+
+void cb2Body::SynchronizeCompound()
+{
+	// Merged bodies are inactive, so only their transform has to follow.
+	for (cb2Body* b = m_compoundList; b; b = b->m_compoundNext)
+	{
+		b->m_xf = cb2Mul(m_xf, b->m_compoundTransform);
+		b->m_sweep.c = cb2Mul(b->m_xf, b->m_sweep.localCenter);
+		b->m_sweep.a = m_sweep.a + b->m_compoundTransform.q.GetAngle();
+		b->m_sweep.c0 = b->m_sweep.c;
+		b->m_sweep.a0 = b->m_sweep.a;
+	}
+}
+
+// Wake the island this body fell asleep with. Its bodies are linked in a ring, so no
+// search of the contact graph is needed. Their contacts go back to the contact manager.
+void cb2Body::WakeIsland()
+{
+	cb2Body* b = this;
+	do
+	{
+		b->m_flags |= e_awakeFlag;
+		b->m_sleepTime = 0.0f;
+
+		for (cb2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			ce->contact->m_flags &= ~cb2Contact::e_sleepFlag;
+		}
+
+		cb2Body* next = b->m_sleepNext;
+		b->m_sleepNext = NULL;
+		b = next;
+	}
+	while (b && b != this);
 }
 
 void cb2Body::SetActive(bool flag)
@@ -477,6 +529,9 @@ void cb2Body::SetActive(bool flag)
 		return;
 	}
 
+	// Merged bodies are activated by splitting them off their compound.
+	cb2Assert(flag == false || m_compound == NULL);
+
 	if (flag)
 	{
 		m_flags |= e_activeFlag;
@@ -539,25 +594,44 @@ void cb2Body::Dump()
 {
 	int bodyIndex = m_islandIndex;
 
+	// Compounds are dumped unmerged. A merged body is dumped active, with the motion
+	// of the compound at its place, and the compound leaves out the fixture copies.
+	ci::Vec2f linearVelocity = m_linearVelocity;
+	float angularVelocity = m_angularVelocity;
+	int awakeFlag = m_flags & e_awakeFlag;
+	int activeFlag = m_flags & e_activeFlag;
+	if (m_compound)
+	{
+		linearVelocity = m_compound->m_linearVelocity + cb2Cross(m_compound->m_angularVelocity, m_sweep.c - m_compound->m_sweep.c);
+		angularVelocity = m_compound->m_angularVelocity;
+		awakeFlag = m_compound->m_flags & e_awakeFlag;
+		activeFlag = m_compound->m_flags & e_activeFlag;
+	}
+
 	cb2Log("{\n");
 	cb2Log("  cb2BodyDef bd;\n");
 	cb2Log("  bd.type = cb2BodyType(%d);\n", m_type);
 	cb2Log("  bd.position.set(%.15lef, %.15lef);\n", m_xf.p.x, m_xf.p.y);
 	cb2Log("  bd.angle = %.15lef;\n", m_sweep.a);
-	cb2Log("  bd.linearVelocity.set(%.15lef, %.15lef);\n", m_linearVelocity.x, m_linearVelocity.y);
-	cb2Log("  bd.angularVelocity = %.15lef;\n", m_angularVelocity);
+	cb2Log("  bd.linearVelocity.set(%.15lef, %.15lef);\n", linearVelocity.x, linearVelocity.y);
+	cb2Log("  bd.angularVelocity = %.15lef;\n", angularVelocity);
 	cb2Log("  bd.linearDamping = %.15lef;\n", m_linearDamping);
 	cb2Log("  bd.angularDamping = %.15lef;\n", m_angularDamping);
 	cb2Log("  bd.allowSleep = bool(%d);\n", m_flags & e_autoSleepFlag);
-	cb2Log("  bd.awake = bool(%d);\n", m_flags & e_awakeFlag);
+	cb2Log("  bd.awake = bool(%d);\n", awakeFlag);
 	cb2Log("  bd.fixedRotation = bool(%d);\n", m_flags & e_fixedRotationFlag);
 	cb2Log("  bd.bullet = bool(%d);\n", m_flags & e_bulletFlag);
-	cb2Log("  bd.active = bool(%d);\n", m_flags & e_activeFlag);
+	cb2Log("  bd.active = bool(%d);\n", activeFlag);
 	cb2Log("  bd.gravityScale = %.15lef;\n", m_gravityScale);
 	cb2Log("  bodies[%d] = m_world->CreateBody(&bd);\n", m_islandIndex);
 	cb2Log("\n");
 	for (cb2Fixture* f = m_fixtureList; f; f = f->m_next)
 	{
+		if (f->m_original)
+		{
+			continue;
+		}
+
 		cb2Log("  {\n");
 		f->Dump(bodyIndex);
 		cb2Log("  }\n");
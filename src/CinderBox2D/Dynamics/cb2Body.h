@@ -385,6 +385,12 @@ public:
 	cb2World* GetWorld();
 	const cb2World* GetWorld() const;
 
+	/// Get the compound body this body is merged into, or NULL if it is not merged.
+	/// A merged body is inactive and follows the compound.
+	/// @see cb2World::MergeBodies
+	cb2Body* GetCompound();
+	const cb2Body* GetCompound() const;
+
 	/// Dump this body to a log file
 	void Dump();
 
@@ -425,6 +431,8 @@ private:
 
 	void SynchronizeFixtures();
 	void SynchronizeTransform();
+	void SynchronizeCompound();
+	void WakeIsland();
 
 	// This is used to prevent connected bodies from colliding.
 	// It may lie, depending on the collideConnected flag.
@@ -457,6 +465,19 @@ private:
 	cb2JointEdge* m_jointList;
 	cb2ContactEdge* m_contactList;
 
+	// The compound this body is merged into, the next body merged into the same
+	// compound, and this body's transform relative to the compound.
+	cb2Body* m_compound;
+	cb2Body* m_compoundNext;
+	cb2Transform m_compoundTransform;
+
+	// The bodies merged into this one.
+	cb2Body* m_compoundList;
+
+	// The next body of the island this body fell asleep with. The bodies of a
+	// sleeping island form a ring. NULL while awake.
+	cb2Body* m_sleepNext;
+
 	float m_mass, m_invMass;
 
 	// Rotational inertia about the center of mass.
@@ -643,6 +664,11 @@ inline void cb2Body::SetAwake(bool flag)
 		{
 			m_flags |= e_awakeFlag;
 			m_sleepTime = 0.0f;
+
+			if (m_sleepNext)
+			{
+				WakeIsland();
+			}
 		}
 	}
 	else
@@ -852,6 +878,16 @@ inline void cb2Body::Advance(float alpha)
 	m_xf.p = m_sweep.c - cb2Mul(m_xf.q, m_sweep.localCenter);
 }
 
+inline cb2Body* cb2Body::GetCompound()
+{
+	return m_compound;
+}
+
+inline const cb2Body* cb2Body::GetCompound() const
+{
+	return m_compound;
+}
+
 inline cb2World* cb2Body::GetWorld()
 {
 	return m_world;
@@ -0,0 +1,73 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <CinderBox2D/Dynamics/cb2BreakBuffer.h>
+#include <memory.h>
+
+cb2BreakBuffer::cb2BreakBuffer()
+{
+	m_jointBreakCapacity = 16;
+	m_jointBreakCount = 0;
+	m_jointBreaks = (cb2JointBreak*)cb2Alloc(m_jointBreakCapacity * sizeof(cb2JointBreak));
+
+	m_contactBreakCapacity = 16;
+	m_contactBreakCount = 0;
+	m_contactBreaks = (cb2ContactBreak*)cb2Alloc(m_contactBreakCapacity * sizeof(cb2ContactBreak));
+}
+
+cb2BreakBuffer::~cb2BreakBuffer()
+{
+	cb2Free(m_jointBreaks);
+	cb2Free(m_contactBreaks);
+}
+
+void cb2BreakBuffer::Clear()
+{
+	m_jointBreakCount = 0;
+	m_contactBreakCount = 0;
+}
+
+void cb2BreakBuffer::Add(const cb2JointBreak& jointBreak)
+{
+	if (m_jointBreakCount == m_jointBreakCapacity)
+	{
+		cb2JointBreak* oldBreaks = m_jointBreaks;
+		m_jointBreakCapacity *= 2;
+		m_jointBreaks = (cb2JointBreak*)cb2Alloc(m_jointBreakCapacity * sizeof(cb2JointBreak));
+		memcpy(m_jointBreaks, oldBreaks, m_jointBreakCount * sizeof(cb2JointBreak));
+		cb2Free(oldBreaks);
+	}
+
+	m_jointBreaks[m_jointBreakCount] = jointBreak;
+	++m_jointBreakCount;
+}
+
+void cb2BreakBuffer::Add(const cb2ContactBreak& contactBreak)
+{
+	if (m_contactBreakCount == m_contactBreakCapacity)
+	{
+		cb2ContactBreak* oldBreaks = m_contactBreaks;
+		m_contactBreakCapacity *= 2;
+		m_contactBreaks = (cb2ContactBreak*)cb2Alloc(m_contactBreakCapacity * sizeof(cb2ContactBreak));
+		memcpy(m_contactBreaks, oldBreaks, m_contactBreakCount * sizeof(cb2ContactBreak));
+		cb2Free(oldBreaks);
+	}
+
+	m_contactBreaks[m_contactBreakCount] = contactBreak;
+	++m_contactBreakCount;
+}
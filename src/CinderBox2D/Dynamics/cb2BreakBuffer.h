@@ -16,24 +16,31 @@
 * 3. This notice may not be removed or altered from any source distribution.
 */
 
-#ifndef CB2_CIRCLE_CONTACT_H
-#define CB2_CIRCLE_CONTACT_H
+#ifndef CB2_BREAK_BUFFER_H
+#define CB2_BREAK_BUFFER_H
 
-#include <CinderBox2D/Dynamics/Contacts/cb2Contact.h>
+#include <CinderBox2D/Dynamics/cb2WorldCallbacks.h>
 
-class cb2BlockAllocator;
-
-class cb2CircleContact : public cb2Contact
+// Delegate of cb2World. Collects the joints and contacts that broke during
+// a time step. The islands add to it right after they store their impulses.
+class cb2BreakBuffer
 {
 public:
-	static cb2Contact* Create(	cb2Fixture* fixtureA, int indexA,
-								cb2Fixture* fixtureB, int indexB, cb2BlockAllocator* allocator);
-	static void Destroy(cb2Contact* contact, cb2BlockAllocator* allocator);
+	cb2BreakBuffer();
+	~cb2BreakBuffer();
+
+	void Clear();
+
+	void Add(const cb2JointBreak& jointBreak);
+	void Add(const cb2ContactBreak& contactBreak);
 
-	cb2CircleContact(cb2Fixture* fixtureA, cb2Fixture* fixtureB);
-	~cb2CircleContact() {}
+	cb2JointBreak* m_jointBreaks;
+	int m_jointBreakCount;
+	int m_jointBreakCapacity;
 
-	void Evaluate(cb2Manifold* manifold, const cb2Transform& xfA, const cb2Transform& xfB);
+	cb2ContactBreak* m_contactBreaks;
+	int m_contactBreakCount;
+	int m_contactBreakCapacity;
 };
 
 #endif
@@ -21,10 +21,31 @@
 #include <CinderBox2D/Dynamics/cb2Fixture.h>
 #include <CinderBox2D/Dynamics/cb2WorldCallbacks.h>
 #include <CinderBox2D/Dynamics/Contacts/cb2Contact.h>
+#include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
+
+#include <memory.h>
 
 cb2ContactFilter cb2_defaultFilter;
 cb2ContactListener cb2_defaultListener;
 
+// Chains with a mid-phase and meshes have one proxy for all their children.
+static inline bool cb2HasMidPhase(const cb2Fixture* fixture)
+{
+	switch (fixture->GetType())
+	{
+	case cb2Shape::e_chain:
+		return ((const cb2ChainShape*)fixture->GetShape())->HasMidPhase();
+
+	case cb2Shape::e_mesh:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
 cb2ContactManager::cb2ContactManager()
 {
 	m_contactList = NULL;
@@ -32,6 +53,25 @@ cb2ContactManager::cb2ContactManager()
 	m_contactFilter = &cb2_defaultFilter;
 	m_contactListener = &cb2_defaultListener;
 	m_allocator = NULL;
+	m_speculativeTime = 0.0f;
+	m_reuseManifolds = false;
+	m_reuseLinearTolerance = cb2_manifoldReuseLinearTolerance;
+	m_reuseAngularTolerance = cb2_manifoldReuseAngularTolerance;
+
+	m_updateCapacity = 64;
+	m_updateBuffer = (cb2Contact**)cb2Alloc(m_updateCapacity * sizeof(cb2Contact*));
+	m_sortedBuffer = (int*)cb2Alloc(m_updateCapacity * sizeof(int));
+	m_updateManifolds = (const cb2Manifold**)cb2Alloc(m_updateCapacity * sizeof(cb2Manifold*));
+	m_manifoldBuffer = (cb2Manifold*)cb2Alloc(m_updateCapacity * sizeof(cb2Manifold));
+
+}
+
+cb2ContactManager::~cb2ContactManager()
+{
+	cb2Free(m_updateBuffer);
+	cb2Free(m_sortedBuffer);
+	cb2Free(m_updateManifolds);
+	cb2Free(m_manifoldBuffer);
 }
 
 void cb2ContactManager::Destroy(cb2Contact* c)
@@ -104,10 +144,26 @@ void cb2ContactManager::Destroy(cb2Contact* c)
 // contact list.
 void cb2ContactManager::Collide()
 {
-	// Update awake contacts.
+	int typeCounts[e_contactTypeCount];
+	for (int i = 0; i < e_contactTypeCount; ++i)
+	{
+		typeCounts[i] = 0;
+	}
+
+	int updateCount = 0;
+
+	// Find the awake contacts that persist.
 	cb2Contact* c = m_contactList;
 	while (c)
 	{
+		// Contacts of sleeping islands wait for a body to wake. This avoids touching
+		// the fixtures and bodies.
+		if ((c->m_flags & (cb2Contact::e_sleepFlag | cb2Contact::e_filterFlag)) == cb2Contact::e_sleepFlag)
+		{
+			c = c->GetNext();
+			continue;
+		}
+
 		cb2Fixture* fixtureA = c->GetFixtureA();
 		cb2Fixture* fixtureB = c->GetFixtureB();
 		int indexA = c->GetChildIndexA();
@@ -150,9 +206,18 @@ void cb2ContactManager::Collide()
 			continue;
 		}
 
-		int proxyIdA = fixtureA->m_proxies[indexA].proxyId;
-		int proxyIdB = fixtureB->m_proxies[indexB].proxyId;
-		bool overlap = m_broadPhase.TestOverlap(proxyIdA, proxyIdB);
+		bool overlap;
+		if (cb2HasMidPhase(fixtureA))
+		{
+			// Contact creation puts the chain or mesh first. Its child index is local.
+			overlap = TestMidPhaseOverlap(fixtureA, indexA, fixtureB->m_proxies[indexB].proxyId);
+		}
+		else
+		{
+			int proxyIdA = fixtureA->m_proxies[indexA].proxyId;
+			int proxyIdB = fixtureB->m_proxies[indexB].proxyId;
+			overlap = m_broadPhase.TestOverlap(proxyIdA, proxyIdB);
+		}
 
 		// Here we destroy contacts that cease to overlap in the broad-phase.
 		if (overlap == false)
@@ -163,10 +228,84 @@ void cb2ContactManager::Collide()
 			continue;
 		}
 
+		// Bound how far the shapes may close in on each other during the step.
+		if (m_speculativeTime > 0.0f)
+		{
+			ci::Vec2f dv = bodyB->m_linearVelocity - bodyA->m_linearVelocity;
+			c->m_speculativeMargin = cb2_speculativeDistance + m_speculativeTime * dv.length();
+		}
+		else
+		{
+			c->m_speculativeMargin = 0.0f;
+		}
+
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (updateCount == m_updateCapacity)
+		{
+			cb2Contact** oldBuffer = m_updateBuffer;
+			m_updateCapacity *= 2;
+			m_updateBuffer = (cb2Contact**)cb2Alloc(m_updateCapacity * sizeof(cb2Contact*));
+			memcpy(m_updateBuffer, oldBuffer, updateCount * sizeof(cb2Contact*));
+			cb2Free(oldBuffer);
+			cb2Free(m_sortedBuffer);
+			cb2Free(m_updateManifolds);
+			cb2Free(m_manifoldBuffer);
+			m_sortedBuffer = (int*)cb2Alloc(m_updateCapacity * sizeof(int));
+			m_updateManifolds = (const cb2Manifold**)cb2Alloc(m_updateCapacity * sizeof(cb2Manifold*));
+			m_manifoldBuffer = (cb2Manifold*)cb2Alloc(m_updateCapacity * sizeof(cb2Manifold));
+		}
+
+		m_updateBuffer[updateCount] = c;
+		++updateCount;
+		++typeCounts[c->m_type];
+
 		c = c->GetNext();
 	}
+
+	// Group the contacts by type, keeping the list order within each type.
+	int offsets[e_contactTypeCount];
+	int offset = 0;
+	for (int i = 0; i < e_contactTypeCount; ++i)
+	{
+		offsets[i] = offset;
+		offset += typeCounts[i];
+	}
+
+	for (int i = 0; i < updateCount; ++i)
+	{
+		int type = m_updateBuffer[i]->m_type;
+		m_sortedBuffer[offsets[type]] = i;
+		++offsets[type];
+	}
+
+	// Evaluate the contacts one type at a time. Sensors and reusable manifolds
+	// are left to Update.
+	float linearTolerance = m_reuseManifolds ? m_reuseLinearTolerance : 0.0f;
+	float angularTolerance = m_reuseManifolds ? m_reuseAngularTolerance : 0.0f;
+	for (int i = 0; i < updateCount; ++i)
+	{
+		int index = m_sortedBuffer[i];
+		cb2Contact* contact = m_updateBuffer[index];
+		const cb2Transform& xfA = contact->m_fixtureA->m_body->m_xf;
+		const cb2Transform& xfB = contact->m_fixtureB->m_body->m_xf;
+
+		if (contact->m_fixtureA->m_isSensor || contact->m_fixtureB->m_isSensor ||
+			(linearTolerance > 0.0f && contact->IsReusable(cb2MulT(xfA, xfB), linearTolerance, angularTolerance)))
+		{
+			m_updateManifolds[index] = NULL;
+			continue;
+		}
+
+		contact->Evaluate(m_manifoldBuffer + i, xfA, xfB);
+		m_updateManifolds[index] = m_manifoldBuffer + i;
+	}
+
+	// Apply the results in list order, so the listener sees the same order as
+	// without grouping.
+	for (int i = 0; i < updateCount; ++i)
+	{
+		m_updateBuffer[i]->Update(m_contactListener, linearTolerance, angularTolerance, m_updateManifolds[i]);
+	}
 }
 
 void cb2ContactManager::FindNewContacts()
@@ -182,9 +321,99 @@ void cb2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	cb2Fixture* fixtureA = proxyA->fixture;
 	cb2Fixture* fixtureB = proxyB->fixture;
 
-	int indexA = proxyA->childIndex;
-	int indexB = proxyB->childIndex;
+	if (cb2HasMidPhase(fixtureA))
+	{
+		AddMidPhaseContacts(fixtureA, proxyB);
+		return;
+	}
+
+	if (cb2HasMidPhase(fixtureB))
+	{
+		AddMidPhaseContacts(fixtureB, proxyA);
+		return;
+	}
+
+	AddContact(fixtureA, proxyA->childIndex, fixtureB, proxyB->childIndex);
+}
+
+// Forwards the children found under the other proxy to AddContact.
+struct cb2MidPhaseContactQuery
+{
+	bool QueryCallback(int index)
+	{
+		manager->AddContact(midPhaseFixture, index, fixture, childIndex);
+		return true;
+	}
+
+	cb2ContactManager* manager;
+	cb2Fixture* midPhaseFixture;
+	cb2Fixture* fixture;
+	int childIndex;
+};
+
+void cb2ContactManager::AddMidPhaseContacts(cb2Fixture* midPhaseFixture, cb2FixtureProxy* proxy)
+{
+	if (midPhaseFixture->GetBody() == proxy->fixture->GetBody())
+	{
+		return;
+	}
+
+	// Bound the fat AABB of the other proxy in the shape frame.
+	const cb2Transform& xf = midPhaseFixture->GetBody()->GetTransform();
+	const cb2AABB& fatAABB = m_broadPhase.GetFatAABB(proxy->proxyId);
+
+	ci::Vec2f center = cb2MulT(xf, fatAABB.GetCenter());
+	ci::Vec2f h = fatAABB.GetExtents();
+	float c = cb2Abs(xf.q.c);
+	float s = cb2Abs(xf.q.s);
+	ci::Vec2f extents(c * h.x + s * h.y, s * h.x + c * h.y);
+
+	cb2AABB aabb;
+	aabb.lowerBound = center - extents;
+	aabb.upperBound = center + extents;
+
+	cb2MidPhaseContactQuery query;
+	query.manager = this;
+	query.midPhaseFixture = midPhaseFixture;
+	query.fixture = proxy->fixture;
+	query.childIndex = proxy->childIndex;
+
+	if (midPhaseFixture->GetType() == cb2Shape::e_chain)
+	{
+		((const cb2ChainShape*)midPhaseFixture->GetShape())->QueryEdges(&query, aabb);
+	}
+	else
+	{
+		((const cb2MeshShape*)midPhaseFixture->GetShape())->QueryPieces(&query, aabb);
+	}
+}
 
+bool cb2ContactManager::TestMidPhaseOverlap(cb2Fixture* midPhaseFixture, int index, int proxyId) const
+{
+	const cb2Transform& xf = midPhaseFixture->GetBody()->GetTransform();
+
+	cb2AABB aabb;
+	if (midPhaseFixture->GetType() == cb2Shape::e_chain)
+	{
+		cb2EdgeShape edge;
+		((const cb2ChainShape*)midPhaseFixture->GetShape())->GetChildEdge(&edge, index);
+		edge.ComputeAABB(&aabb, xf, 0);
+	}
+	else
+	{
+		((const cb2MeshShape*)midPhaseFixture->GetShape())->ComputePieceAABB(&aabb, xf, index);
+	}
+
+	// Fatten the child like the leaves of the local tree.
+	ci::Vec2f r(cb2_aabbExtension, cb2_aabbExtension);
+	aabb.lowerBound -= r;
+	aabb.upperBound += r;
+
+	return cb2TestOverlap(aabb, m_broadPhase.GetFatAABB(proxyId));
+}
+
+void cb2ContactManager::AddContact(cb2Fixture* fixtureA, int indexA, cb2Fixture* fixtureB, int indexB)
+{
 	cb2Body* bodyA = fixtureA->GetBody();
 	cb2Body* bodyB = fixtureB->GetBody();
 
@@ -20,26 +20,42 @@
 #define CB2_CONTACT_MANAGER_H
 
 #include <CinderBox2D/Collision/cb2BroadPhase.h>
+#include <CinderBox2D/Collision/cb2Collision.h>
 
 class cb2Contact;
 class cb2ContactFilter;
 class cb2ContactListener;
 class cb2BlockAllocator;
+class cb2Fixture;
+struct cb2FixtureProxy;
 
 // Delegate of cb2World.
 class cb2ContactManager
 {
 public:
 	cb2ContactManager();
+	~cb2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
 
+	// Create a contact between two fixture children unless the pair is filtered
+	// or the contact already exists.
+	void AddContact(cb2Fixture* fixtureA, int indexA, cb2Fixture* fixtureB, int indexB);
+
+	// Create contacts between the other proxy and the children of a chain with a
+	// mid-phase or a mesh that lie under its fat AABB.
+	void AddMidPhaseContacts(cb2Fixture* midPhaseFixture, cb2FixtureProxy* proxy);
+
+	// Does a child of a chain with a mid-phase or a mesh still overlap the other proxy?
+	bool TestMidPhaseOverlap(cb2Fixture* midPhaseFixture, int index, int proxyId) const;
+
 	void FindNewContacts();
 
 	void Destroy(cb2Contact* c);
 
 	void Collide();
+
             
 	cb2BroadPhase m_broadPhase;
 	cb2Contact* m_contactList;
@@ -47,6 +63,23 @@ public:
 	cb2ContactFilter* m_contactFilter;
 	cb2ContactListener* m_contactListener;
 	cb2BlockAllocator* m_allocator;
+
+	// Persisting contacts gathered by Collide in list order. Their positions are
+	// grouped by contact type so that each collision routine runs over a contiguous
+	// batch. The new manifolds are then applied in list order, which keeps the
+	// order of the listener callbacks.
+	cb2Contact** m_updateBuffer;
+	int* m_sortedBuffer;
+	const cb2Manifold** m_updateManifolds;
+	cb2Manifold* m_manifoldBuffer;
+	int m_updateCapacity;
+
+	// The step length while speculative contacts are enabled, zero otherwise.
+	float m_speculativeTime;
+
+	bool m_reuseManifolds;
+	float m_reuseLinearTolerance;
+	float m_reuseAngularTolerance;
 };
 
 #endif
@@ -22,7 +22,9 @@
 #include <CinderBox2D/Collision/Shapes/cb2CircleShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
 #include <CinderBox2D/Collision/cb2BroadPhase.h>
 #include <CinderBox2D/Collision/cb2Collision.h>
 #include <CinderBox2D/Common/cb2BlockAllocator.h>
@@ -36,6 +38,7 @@ cb2Fixture::cb2Fixture()
 	m_proxyCount = 0;
 	m_shape = NULL;
 	m_density = 0.0f;
+	m_original = NULL;
 }
 
 void cb2Fixture::Create(cb2BlockAllocator* allocator, cb2Body* body, const cb2FixtureDef* def)
@@ -43,6 +46,8 @@ void cb2Fixture::Create(cb2BlockAllocator* allocator, cb2Body* body, const cb2Fi
 	m_userData = def->userData;
 	m_friction = def->friction;
 	m_restitution = def->restitution;
+	cb2Assert(def->breakForce >= 0.0f);
+	m_breakForce = def->breakForce;
 
 	m_body = body;
 	m_next = NULL;
@@ -111,6 +116,22 @@ void cb2Fixture::Destroy(cb2BlockAllocator* allocator)
 		}
 		break;
 
+	case cb2Shape::e_capsule:
+		{
+			cb2CapsuleShape* s = (cb2CapsuleShape*)m_shape;
+			s->~cb2CapsuleShape();
+			allocator->Free(s, sizeof(cb2CapsuleShape));
+		}
+		break;
+
+	case cb2Shape::e_mesh:
+		{
+			cb2MeshShape* s = (cb2MeshShape*)m_shape;
+			s->~cb2MeshShape();
+			allocator->Free(s, sizeof(cb2MeshShape));
+		}
+		break;
+
 	default:
 		cb2Assert(false);
 		break;
@@ -236,6 +257,10 @@ void cb2Fixture::Dump(int bodyIndex)
 	cb2Log("    fd.filter.categoryBits = unsigned short(%d);\n", m_filter.categoryBits);
 	cb2Log("    fd.filter.maskBits = unsigned short(%d);\n", m_filter.maskBits);
 	cb2Log("    fd.filter.groupIndex = short(%d);\n", m_filter.groupIndex);
+	if (m_breakForce < cb2_maxFloat)
+	{
+		cb2Log("    fd.breakForce = %.15lef;\n", m_breakForce);
+	}
 
 	switch (m_shape->m_type)
 	{
@@ -272,6 +297,10 @@ void cb2Fixture::Dump(int bodyIndex)
 				cb2Log("    vs[%d].set(%.15lef, %.15lef);\n", i, s->m_vertices[i].x, s->m_vertices[i].y);
 			}
 			cb2Log("    shape.set(vs, %d);\n", s->m_count);
+			if (s->m_radius != cb2_polygonRadius)
+			{
+				cb2Log("    shape.SetRadius(%.15lef);\n", s->m_radius);
+			}
 		}
 		break;
 
@@ -289,6 +318,43 @@ void cb2Fixture::Dump(int bodyIndex)
 			cb2Log("    shape.m_nextVertex.set(%.15lef, %.15lef);\n", s->m_nextVertex.x, s->m_nextVertex.y);
 			cb2Log("    shape.m_hasPrevVertex = bool(%d);\n", s->m_hasPrevVertex);
 			cb2Log("    shape.m_hasNextVertex = bool(%d);\n", s->m_hasNextVertex);
+			cb2Log("    shape.SetMidPhase(bool(%d));\n", s->m_midPhase);
+		}
+		break;
+
+	case cb2Shape::e_capsule:
+		{
+			cb2CapsuleShape* s = (cb2CapsuleShape*)m_shape;
+			cb2Log("    cb2CapsuleShape shape;\n");
+			cb2Log("    shape.m_radius = %.15lef;\n", s->m_radius);
+			cb2Log("    shape.m_vertex1.set(%.15lef, %.15lef);\n", s->m_vertex1.x, s->m_vertex1.y);
+			cb2Log("    shape.m_vertex2.set(%.15lef, %.15lef);\n", s->m_vertex2.x, s->m_vertex2.y);
+		}
+		break;
+
+	case cb2Shape::e_mesh:
+		{
+			cb2MeshShape* s = (cb2MeshShape*)m_shape;
+			int indexCount = s->m_pieceSize * s->m_pieceCount;
+			cb2Log("    cb2MeshShape shape;\n");
+			cb2Log("    ci::Vec2f vs[%d];\n", s->m_vertexCount);
+			for (int i = 0; i < s->m_vertexCount; ++i)
+			{
+				cb2Log("    vs[%d].set(%.15lef, %.15lef);\n", i, s->m_vertices[i].x, s->m_vertices[i].y);
+			}
+			cb2Log("    int is[%d];\n", indexCount);
+			for (int i = 0; i < indexCount; ++i)
+			{
+				cb2Log("    is[%d] = %d;\n", i, s->m_indices[i]);
+			}
+			if (s->HasSegments())
+			{
+				cb2Log("    shape.CreateSegments(vs, %d, is, %d);\n", s->m_vertexCount, s->m_pieceCount);
+			}
+			else
+			{
+				cb2Log("    shape.CreateTriangles(vs, %d, is, %d);\n", s->m_vertexCount, s->m_pieceCount);
+			}
 		}
 		break;
 
@@ -64,6 +64,7 @@ struct cb2FixtureDef
 		restitution = 0.0f;
 		density = 0.0f;
 		isSensor = false;
+		breakForce = cb2_maxFloat;
 	}
 
 	/// The shape, this must be set. The shape will be cloned, so you
@@ -82,6 +83,10 @@ struct cb2FixtureDef
 	/// The density, usually in kg/m^2.
 	float density;
 
+	/// A contact breaks when its normal force exceeds this, in Newtons. The lower
+	/// value of the two fixtures applies.
+	float breakForce;
+
 	/// A sensor shape collects contact information but never generates a collision
 	/// response.
 	bool isSensor;
@@ -187,6 +192,19 @@ public:
 	/// existing contacts.
 	void SetRestitution(float restitution);
 
+	/// Get the normal force above which contacts break.
+	float GetBreakForce() const;
+
+	/// Set the normal force above which contacts break. This will _not_ change the break
+	/// force of existing contacts.
+	void SetBreakForce(float force);
+
+	/// Get the fixture this one was copied from when its body was merged into a
+	/// compound, or NULL. Use GetOriginal()->GetBody() to find the merged body.
+	/// @see cb2World::MergeBodies
+	cb2Fixture* GetOriginal();
+	const cb2Fixture* GetOriginal() const;
+
 	/// Get the fixture's AABB. This AABB may be enlarge and/or stale.
 	/// If you need a more accurate AABB, compute it using the shape and
 	/// the body transform.
@@ -224,6 +242,7 @@ protected:
 
 	float m_friction;
 	float m_restitution;
+	float m_breakForce;
 
 	cb2FixtureProxy* m_proxies;
 	int m_proxyCount;
@@ -232,6 +251,8 @@ protected:
 
 	bool m_isSensor;
 
+	cb2Fixture* m_original;
+
 	void* m_userData;
 };
 
@@ -321,6 +342,27 @@ inline void cb2Fixture::SetRestitution(float restitution)
 	m_restitution = restitution;
 }
 
+inline float cb2Fixture::GetBreakForce() const
+{
+	return m_breakForce;
+}
+
+inline void cb2Fixture::SetBreakForce(float force)
+{
+	cb2Assert(force >= 0.0f);
+	m_breakForce = force;
+}
+
+inline cb2Fixture* cb2Fixture::GetOriginal()
+{
+	return m_original;
+}
+
+inline const cb2Fixture* cb2Fixture::GetOriginal() const
+{
+	return m_original;
+}
+
 inline bool cb2Fixture::TestPoint(const ci::Vec2f& p) const
 {
 	return m_shape->TestPoint(m_body->GetTransform(), p);
@@ -18,6 +18,7 @@
 
 #include <CinderBox2D/Collision/cb2Distance.h>
 #include <CinderBox2D/Dynamics/cb2Island.h>
+#include <CinderBox2D/Dynamics/cb2BreakBuffer.h>
 #include <CinderBox2D/Dynamics/cb2Body.h>
 #include <CinderBox2D/Dynamics/cb2Fixture.h>
 #include <CinderBox2D/Dynamics/cb2World.h>
@@ -150,7 +151,8 @@ cb2Island::cb2Island(
 	int contactCapacity,
 	int jointCapacity,
 	cb2StackAllocator* allocator,
-	cb2ContactListener* listener)
+	cb2ContactListener* listener,
+	cb2BreakBuffer* breaks)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
@@ -161,6 +163,7 @@ cb2Island::cb2Island(
 
 	m_allocator = allocator;
 	m_listener = listener;
+	m_breaks = breaks;
 
 	m_bodies = (cb2Body**)m_allocator->Allocate(bodyCapacity * sizeof(cb2Body*));
 	m_contacts = (cb2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(cb2Contact*));
@@ -182,6 +185,12 @@ cb2Island::~cb2Island()
 
 void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Vec2f& gravity, bool allowSleep)
 {
+	if (step.softSubSteps > 0)
+	{
+		SolveSoft(profile, step, gravity, allowSleep);
+		return;
+	}
+
 	cb2Timer timer;
 
 	float h = step.dt;
@@ -196,12 +205,19 @@ void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Ve
 		ci::Vec2f v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
-
-		if (b->m_type == cb2_dynamicBody)
+		if (b->m_type != cb2_dynamicBody)
+		{
+			// Kinematic bodies were already moved by the world. Start them where
+			// they were at the beginning of the step.
+			c = b->m_sweep.c0;
+			a = b->m_sweep.a0;
+		}
+		else
 		{
+			// Store positions for continuous collision.
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+
 			// Integrate velocities.
 			v += h * (b->m_gravityScale * gravity + b->m_invMass * b->m_force);
 			w += h * b->m_invI * b->m_torque;
@@ -243,6 +259,9 @@ void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Ve
 	cb2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
 
+	// Small islands fall back to the iterative solver if they have too many points.
+	bool direct = step.directSolver && contactSolver.InitializeDirectConstraints();
+
 	if (step.warmStarting)
 	{
 		contactSolver.WarmStart();
@@ -257,52 +276,50 @@ void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Ve
 
 	// Solve velocity constraints
 	timer.Reset();
-	for (int i = 0; i < step.velocityIterations; ++i)
+	bool checkConvergence = step.velocityTolerance > 0.0f;
+	int velocityIterations = 0;
+	while (velocityIterations < step.velocityIterations)
 	{
+		float maxChange = 0.0f;
 		for (int j = 0; j < m_jointCount; ++j)
 		{
-			m_joints[j]->SolveVelocityConstraints(solverData);
+			if (checkConvergence)
+			{
+				maxChange = cb2Max(maxChange, SolveJointVelocity(m_joints[j], solverData));
+			}
+			else
+			{
+				m_joints[j]->SolveVelocityConstraints(solverData);
+			}
 		}
 
-		contactSolver.SolveVelocityConstraints();
-	}
-
-	// Store impulses for warm starting
-	contactSolver.StoreImpulses();
-	profile->solveVelocity = timer.GetMilliseconds();
-
-	// Integrate positions
-	for (int i = 0; i < m_bodyCount; ++i)
-	{
-		ci::Vec2f c = m_positions[i].c;
-		float a = m_positions[i].a;
-		ci::Vec2f v = m_velocities[i].v;
-		float w = m_velocities[i].w;
-
-		// Check for large velocities
-		ci::Vec2f translation = h * v;
-		if (cb2Dot(translation, translation) > cb2_maxTranslationSquared)
+		if (direct)
 		{
-			float ratio = cb2_maxTranslation / translation.length();
-			v *= ratio;
+			maxChange = cb2Max(maxChange, contactSolver.SolveDirectVelocityConstraints());
 		}
+		else
+		{
+			maxChange = cb2Max(maxChange, contactSolver.SolveVelocityConstraints());
+		}
+		++velocityIterations;
 
-		float rotation = h * w;
-		if (rotation * rotation > cb2_maxRotationSquared)
+		// Exit early once a pass barely changes the velocities.
+		if (checkConvergence && velocityIterations >= step.minVelocityIterations &&
+			maxChange < step.velocityTolerance)
 		{
-			float ratio = cb2_maxRotation / cb2Abs(rotation);
-			w *= ratio;
+			break;
 		}
+	}
 
-		// Integrate
-		c += h * v;
-		a += h * w;
+	profile->velocityIterations = velocityIterations;
 
-		m_positions[i].c = c;
-		m_positions[i].a = a;
-		m_velocities[i].v = v;
-		m_velocities[i].w = w;
-	}
+	// Store impulses for warm starting
+	contactSolver.StoreImpulses();
+	Break(contactSolver.m_velocityConstraints, h);
+	profile->solveVelocity = timer.GetMilliseconds();
+
+	// Integrate positions
+	IntegratePositions(h, h);
 
 	// Solve position constraints
 	timer.Reset();
@@ -326,10 +343,15 @@ void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Ve
 		}
 	}
 
-	// Copy state buffers back to the bodies
+	// Copy state buffers back to the bodies. Only dynamic bodies are moved by islands.
 	for (int i = 0; i < m_bodyCount; ++i)
 	{
 		cb2Body* body = m_bodies[i];
+		if (body->m_type != cb2_dynamicBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -343,41 +365,353 @@ void cb2Island::Solve(cb2Profile* profile, const cb2TimeStep& step, const ci::Ve
 
 	if (allowSleep)
 	{
-		float minSleepTime = cb2_maxFloat;
+		UpdateSleep(h, positionSolved);
+	}
+}
 
-		const float linTolSqr = cb2_linearSleepTolerance * cb2_linearSleepTolerance;
-		const float angTolSqr = cb2_angularSleepTolerance * cb2_angularSleepTolerance;
+// The squared size of a velocity change of a body. The angular part is scaled by the radius
+// of gyration, so a spin counts like the speed it gives a typical point of the body.
+static float cb2BodyVelocityChange(float invMass, float invI, const ci::Vec2f& dv, float dw)
+{
+	float changeSqr = cb2Dot(dv, dv);
+	if (invI > 0.0f)
+	{
+		changeSqr += (invMass / invI) * dw * dw;
+	}
+	return changeSqr;
+}
+
+// Solve the velocity constraints of a joint and return the largest velocity change it
+// made to one of its bodies, including rotation. Joints keep no common impulse, so the
+// change is read from the bodies.
+float cb2Island::SolveJointVelocity(cb2Joint* joint, const cb2SolverData& data)
+{
+	int indexA = joint->m_bodyA->m_islandIndex;
+	int indexB = joint->m_bodyB->m_islandIndex;
+	cb2Velocity vA = data.velocities[indexA];
+	cb2Velocity vB = data.velocities[indexB];
+
+	joint->SolveVelocityConstraints(data);
+
+	const cb2Body* bA = joint->m_bodyA;
+	const cb2Body* bB = joint->m_bodyB;
+	float changeA = cb2BodyVelocityChange(bA->m_invMass, bA->m_invI, data.velocities[indexA].v - vA.v, data.velocities[indexA].w - vA.w);
+	float changeB = cb2BodyVelocityChange(bB->m_invMass, bB->m_invI, data.velocities[indexB].v - vB.v, data.velocities[indexB].w - vB.w);
+	return cb2Sqrt(cb2Max(changeA, changeB));
+}
 
+// Integrate positions over h and clamp large velocities. The limits apply to the
+// motion over the full step dt, which is longer than h for sub-steps.
+void cb2Island::IntegratePositions(float h, float dt)
+{
+	for (int i = 0; i < m_bodyCount; ++i)
+	{
+		ci::Vec2f c = m_positions[i].c;
+		float a = m_positions[i].a;
+		ci::Vec2f v = m_velocities[i].v;
+		float w = m_velocities[i].w;
+
+		// Check for large velocities
+		ci::Vec2f translation = dt * v;
+		if (cb2Dot(translation, translation) > cb2_maxTranslationSquared)
+		{
+			float ratio = cb2_maxTranslation / translation.length();
+			v *= ratio;
+		}
+
+		float rotation = dt * w;
+		if (rotation * rotation > cb2_maxRotationSquared)
+		{
+			float ratio = cb2_maxRotation / cb2Abs(rotation);
+			w *= ratio;
+		}
+
+		// Integrate
+		c += h * v;
+		a += h * w;
+
+		m_positions[i].c = c;
+		m_positions[i].a = a;
+		m_velocities[i].v = v;
+		m_velocities[i].w = w;
+	}
+}
+
+void cb2Island::UpdateSleep(float h, bool positionSolved)
+{
+	float minSleepTime = cb2_maxFloat;
+
+	const float linTolSqr = cb2_linearSleepTolerance * cb2_linearSleepTolerance;
+	const float angTolSqr = cb2_angularSleepTolerance * cb2_angularSleepTolerance;
+
+	for (int i = 0; i < m_bodyCount; ++i)
+	{
+		cb2Body* b = m_bodies[i];
+		if (b->GetType() == cb2_staticBody)
+		{
+			continue;
+		}
+
+		// Kinematic bodies keep their own sleep time, but one that moves keeps the
+		// island awake.
+		if (b->GetType() == cb2_kinematicBody)
+		{
+			if (b->m_angularVelocity * b->m_angularVelocity > angTolSqr ||
+				cb2Dot(b->m_linearVelocity, b->m_linearVelocity) > linTolSqr)
+			{
+				minSleepTime = 0.0f;
+			}
+			continue;
+		}
+
+		if ((b->m_flags & cb2Body::e_autoSleepFlag) == 0 ||
+			b->m_angularVelocity * b->m_angularVelocity > angTolSqr ||
+			cb2Dot(b->m_linearVelocity, b->m_linearVelocity) > linTolSqr)
+		{
+			b->m_sleepTime = 0.0f;
+			minSleepTime = 0.0f;
+		}
+		else
+		{
+			b->m_sleepTime += h;
+			minSleepTime = cb2Min(minSleepTime, b->m_sleepTime);
+		}
+	}
+
+	if (minSleepTime >= cb2_timeToSleep && positionSolved)
+	{
+		// Link the dynamic bodies in a ring. Waking any of them wakes the island.
+		cb2Body* first = NULL;
+		cb2Body* last = NULL;
 		for (int i = 0; i < m_bodyCount; ++i)
 		{
 			cb2Body* b = m_bodies[i];
-			if (b->GetType() == cb2_staticBody)
+			if (b->GetType() != cb2_kinematicBody)
+			{
+				b->SetAwake(false);
+			}
+
+			if (b->GetType() != cb2_dynamicBody)
 			{
 				continue;
 			}
 
-			if ((b->m_flags & cb2Body::e_autoSleepFlag) == 0 ||
-				b->m_angularVelocity * b->m_angularVelocity > angTolSqr ||
-				cb2Dot(b->m_linearVelocity, b->m_linearVelocity) > linTolSqr)
+			if (last)
 			{
-				b->m_sleepTime = 0.0f;
-				minSleepTime = 0.0f;
+				last->m_sleepNext = b;
 			}
 			else
 			{
-				b->m_sleepTime += h;
-				minSleepTime = cb2Min(minSleepTime, b->m_sleepTime);
+				first = b;
 			}
+			last = b;
 		}
 
-		if (minSleepTime >= cb2_timeToSleep && positionSolved)
+		if (last == NULL)
 		{
-			for (int i = 0; i < m_bodyCount; ++i)
+			return;
+		}
+
+		last->m_sleepNext = first;
+
+		// Flag the contacts that only join sleeping islands and static bodies, so the
+		// contact manager skips them until one of the rings wakes.
+		cb2Body* b = first;
+		do
+		{
+			for (cb2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
 			{
-				cb2Body* b = m_bodies[i];
-				b->SetAwake(false);
+				cb2Body* other = ce->other;
+				if (other->m_type == cb2_staticBody || other->m_sleepNext != NULL)
+				{
+					ce->contact->m_flags |= cb2Contact::e_sleepFlag;
+				}
 			}
+			b = b->m_sleepNext;
 		}
+		while (b != first);
+	}
+}
+
+/*
+Soft Step
+
+The soft step solver splits the step into sub-steps. Each sub-step integrates the
+velocities, warm starts, runs one velocity pass with soft contacts, integrates the
+positions and runs one relaxing velocity pass without the push out bias. A restitution
+pass follows the last sub-step.
+
+Soft contacts are stiff, heavily damped springs. Overlap is removed smoothly at a
+bounded velocity instead of by the nonlinear position solver, so no energy is added
+to stacks. Small sub-steps give the stiffness that the classic solver gets from many
+iterations. Joints keep their rigid velocity solver and run one position pass per
+sub-step.
+
+The impulses of the last sub-step are scaled to the whole step before they are stored,
+so listeners and joint reactions see the same magnitudes as with the classic solver.
+Velocities are clamped by cb2_maxTranslation and cb2_maxRotation per step, not per
+sub-step.
+*/
+void cb2Island::SolveSoft(cb2Profile* profile, const cb2TimeStep& step, const ci::Vec2f& gravity, bool allowSleep)
+{
+	cb2Timer timer;
+
+	int subStepCount = step.softSubSteps;
+	float h = step.dt / subStepCount;
+
+	// Initialize the body state. Forces are integrated in each sub-step.
+	for (int i = 0; i < m_bodyCount; ++i)
+	{
+		cb2Body* b = m_bodies[i];
+
+		// Store positions for continuous collision. Kinematic bodies were already
+		// moved by the world and start where they were.
+		if (b->m_type == cb2_dynamicBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
+
+		m_positions[i].c = b->m_sweep.c0;
+		m_positions[i].a = b->m_sweep.a0;
+		m_velocities[i].v = b->m_linearVelocity;
+		m_velocities[i].w = b->m_angularVelocity;
+	}
+
+	// The stored impulses cover a whole step, so warm starting scales them to a sub-step.
+	cb2TimeStep subStep = step;
+	subStep.dt = h;
+	subStep.inv_dt = subStepCount * step.inv_dt;
+	subStep.dtRatio = step.dtRatio / subStepCount;
+
+	// Solver data
+	cb2SolverData solverData;
+	solverData.step = subStep;
+	solverData.positions = m_positions;
+	solverData.velocities = m_velocities;
+
+	cb2ContactSolverDef contactSolverDef;
+	contactSolverDef.step = subStep;
+	contactSolverDef.contacts = m_contacts;
+	contactSolverDef.count = m_contactCount;
+	contactSolverDef.positions = m_positions;
+	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.allocator = m_allocator;
+
+	cb2ContactSolver contactSolver(&contactSolverDef);
+	contactSolver.InitializeSoftConstraints();
+
+	profile->solveInit = timer.GetMilliseconds();
+
+	timer.Reset();
+	for (int i = 0; i < subStepCount; ++i)
+	{
+		// Integrate velocities and apply damping.
+		for (int j = 0; j < m_bodyCount; ++j)
+		{
+			cb2Body* b = m_bodies[j];
+			if (b->m_type != cb2_dynamicBody)
+			{
+				continue;
+			}
+
+			ci::Vec2f v = m_velocities[j].v;
+			float w = m_velocities[j].w;
+
+			v += h * (b->m_gravityScale * gravity + b->m_invMass * b->m_force);
+			w += h * b->m_invI * b->m_torque;
+
+			v *= 1.0f / (1.0f + h * b->m_linearDamping);
+			w *= 1.0f / (1.0f + h * b->m_angularDamping);
+
+			m_velocities[j].v = v;
+			m_velocities[j].w = w;
+		}
+
+		// Warm start with the impulses of the previous sub-step. Joints also refresh
+		// their anchors from the current positions.
+		for (int j = 0; j < m_jointCount; ++j)
+		{
+			m_joints[j]->InitVelocityConstraints(solverData);
+		}
+
+		if (step.warmStarting)
+		{
+			contactSolver.WarmStart();
+		}
+
+		for (int j = 0; j < m_jointCount; ++j)
+		{
+			m_joints[j]->SolveVelocityConstraints(solverData);
+		}
+
+		contactSolver.SolveSoftVelocityConstraints(true);
+
+		IntegratePositions(h, step.dt);
+
+		for (int j = 0; j < m_jointCount; ++j)
+		{
+			m_joints[j]->SolvePositionConstraints(solverData);
+		}
+
+		// Relax
+		for (int j = 0; j < m_jointCount; ++j)
+		{
+			m_joints[j]->SolveVelocityConstraints(solverData);
+		}
+
+		contactSolver.SolveSoftVelocityConstraints(false);
+
+		// Stored impulses belong to the previous sub-step from now on.
+		solverData.step.dtRatio = 1.0f;
+	}
+
+	profile->velocityIterations = subStepCount;
+
+	contactSolver.ApplyRestitution();
+
+	// Scale the impulses of the last sub-step to the whole step. They are reported
+	// and warm start the next step like those of the classic solver.
+	contactSolver.FinishSoftImpulses(subStepCount);
+	for (int i = 0; i < m_jointCount; ++i)
+	{
+		cb2JointImpulse impulses;
+		m_joints[i]->GetImpulses(&impulses);
+		impulses.impulse *= (float)subStepCount;
+		impulses.motorImpulse *= subStepCount;
+		impulses.springImpulse *= subStepCount;
+		m_joints[i]->SetImpulses(impulses);
+	}
+
+	contactSolver.StoreImpulses();
+	Break(contactSolver.m_velocityConstraints, step.dt);
+	profile->solveVelocity = timer.GetMilliseconds();
+
+	// Copy state buffers back to the bodies. Only dynamic bodies are moved by islands.
+	timer.Reset();
+	for (int i = 0; i < m_bodyCount; ++i)
+	{
+		cb2Body* body = m_bodies[i];
+		if (body->m_type != cb2_dynamicBody)
+		{
+			continue;
+		}
+
+		body->m_sweep.c = m_positions[i].c;
+		body->m_sweep.a = m_positions[i].a;
+		body->m_linearVelocity = m_velocities[i].v;
+		body->m_angularVelocity = m_velocities[i].w;
+		body->SynchronizeTransform();
+	}
+
+	profile->solvePosition = timer.GetMilliseconds();
+
+	Report(contactSolver.m_velocityConstraints);
+
+	// The soft contacts leave no position error to wait for.
+	if (allowSleep)
+	{
+		UpdateSleep(step.dt, true);
 	}
 }
 
@@ -513,6 +847,85 @@ void cb2Island::SolveTOI(const cb2TimeStep& subStep, int toiIndexA, int toiIndex
 	Report(contactSolver.m_velocityConstraints);
 }
 
+// Compare the impulses of the step against the break thresholds. The impulses
+// were accumulated over h, so they are divided by h to get forces. Broken joints
+// are dropped from the island so the position solver leaves them alone.
+void cb2Island::Break(const cb2ContactVelocityConstraint* constraints, float h)
+{
+	if (m_breaks == NULL)
+	{
+		return;
+	}
+
+	float inv_h = 1.0f / h;
+
+	int jointCount = 0;
+	for (int i = 0; i < m_jointCount; ++i)
+	{
+		cb2Joint* joint = m_joints[i];
+		if (joint->m_breakForce < cb2_maxFloat || joint->m_breakTorque < cb2_maxFloat)
+		{
+			cb2JointReaction reaction;
+			joint->GetReaction(&reaction);
+
+			float maxImpulse = joint->m_breakForce * h;
+			float maxAngularImpulse = joint->m_breakTorque * h;
+			if (reaction.linearImpulse.lengthSquared() > maxImpulse * maxImpulse ||
+				cb2Abs(reaction.angularImpulse) > maxAngularImpulse)
+			{
+				joint->m_broken = true;
+
+				cb2JointBreak jointBreak;
+				jointBreak.joint = joint;
+				jointBreak.force = inv_h * reaction.linearImpulse;
+				jointBreak.torque = inv_h * reaction.angularImpulse;
+				m_breaks->Add(jointBreak);
+				continue;
+			}
+		}
+
+		m_joints[jointCount++] = joint;
+	}
+	m_jointCount = jointCount;
+
+	for (int i = 0; i < m_contactCount; ++i)
+	{
+		cb2Contact* c = m_contacts[i];
+		float breakForce = c->GetBreakForce();
+		if (breakForce == cb2_maxFloat)
+		{
+			continue;
+		}
+
+		const cb2ContactVelocityConstraint* vc = constraints + i;
+
+		float normalImpulse = 0.0f;
+		ci::Vec2f weightedPoint = ci::Vec2f::zero();
+		for (int j = 0; j < vc->pointCount; ++j)
+		{
+			normalImpulse += vc->points[j].normalImpulse;
+			weightedPoint += vc->points[j].normalImpulse * vc->points[j].rA;
+		}
+
+		if (normalImpulse <= breakForce * h)
+		{
+			continue;
+		}
+
+		cb2ContactBreak contactBreak;
+		contactBreak.contact = c;
+		contactBreak.fixtureA = c->GetFixtureA();
+		contactBreak.fixtureB = c->GetFixtureB();
+		contactBreak.point = m_positions[vc->indexA].c + (1.0f / normalImpulse) * weightedPoint;
+		contactBreak.normal = vc->normal;
+		contactBreak.normalForce = inv_h * normalImpulse;
+		m_breaks->Add(contactBreak);
+
+		// Report the break once. ResetBreakForce arms the contact again.
+		c->m_breakForce = cb2_maxFloat;
+	}
+}
+
 void cb2Island::Report(const cb2ContactVelocityConstraint* constraints)
 {
 	if (m_listener == NULL)
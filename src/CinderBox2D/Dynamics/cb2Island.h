@@ -27,6 +27,7 @@ class cb2Contact;
 class cb2Joint;
 class cb2StackAllocator;
 class cb2ContactListener;
+class cb2BreakBuffer;
 struct cb2ContactVelocityConstraint;
 struct cb2Profile;
 
@@ -35,7 +36,7 @@ class cb2Island
 {
 public:
 	cb2Island(int bodyCapacity, int contactCapacity, int jointCapacity,
-			cb2StackAllocator* allocator, cb2ContactListener* listener);
+			cb2StackAllocator* allocator, cb2ContactListener* listener, cb2BreakBuffer* breaks);
 	~cb2Island();
 
 	void Clear()
@@ -70,9 +71,16 @@ public:
 	}
 
 	void Report(const cb2ContactVelocityConstraint* constraints);
+	void Break(const cb2ContactVelocityConstraint* constraints, float h);
+
+	void SolveSoft(cb2Profile* profile, const cb2TimeStep& step, const ci::Vec2f& gravity, bool allowSleep);
+	float SolveJointVelocity(cb2Joint* joint, const cb2SolverData& data);
+	void IntegratePositions(float h, float dt);
+	void UpdateSleep(float h, bool positionSolved);
 
 	cb2StackAllocator* m_allocator;
 	cb2ContactListener* m_listener;
+	cb2BreakBuffer* m_breaks;
 
 	cb2Body** m_bodies;
 	cb2Contact** m_contacts;
@@ -21,7 +21,7 @@
 
 #include <CinderBox2D/Common/cb2Math.h>
 
-/// Profiling data. Times are in milliseconds.
+/// Profiling data. Times are in milliseconds. Iteration counts are for the last step.
 struct cb2Profile
 {
 	float step;
@@ -32,6 +32,8 @@ struct cb2Profile
 	float solvePosition;
 	float broadphase;
 	float solveTOI;
+	int velocityIterations;		///< velocity passes summed over the islands
+	int maxVelocityIterations;	///< most velocity passes taken by one island
 };
 
 /// This is an internal structure.
@@ -42,7 +44,12 @@ struct cb2TimeStep
 	float dtRatio;	// dt * inv_dt0
 	int velocityIterations;
 	int positionIterations;
+	float velocityTolerance;	// stop velocity passes below this change, 0 to run all
+	int minVelocityIterations;
 	bool warmStarting;
+	bool speculative;	// limit the approach of separated contact points
+	int softSubSteps;	// sub-steps of the soft step solver, 0 for the classic solver
+	bool directSolver;	// solve the contact normal impulses of the island together
 };
 
 /// This is an internal structure.
@@ -29,6 +29,8 @@
 #include <CinderBox2D/Collision/Shapes/cb2EdgeShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2ChainShape.h>
 #include <CinderBox2D/Collision/Shapes/cb2PolygonShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2CapsuleShape.h>
+#include <CinderBox2D/Collision/Shapes/cb2MeshShape.h>
 #include <CinderBox2D/Collision/cb2TimeOfImpact.h>
 #include <CinderBox2D/Common/cb2Draw.h>
 #include <CinderBox2D/Common/cb2Timer.h>
@@ -37,6 +39,7 @@
 cb2World::cb2World(const ci::Vec2f& gravity)
 {
 	m_destructionListener = NULL;
+	m_iterationPolicy = NULL;
 	g_debugDraw = NULL;
 
 	m_bodyList = NULL;
@@ -47,6 +50,11 @@ cb2World::cb2World(const ci::Vec2f& gravity)
 
 	m_warmStarting = true;
 	m_continuousPhysics = true;
+	m_speculativeContacts = false;
+	m_softSubSteps = 0;
+	m_velocityTolerance = 0.0f;
+	m_directSolverMassRatio = 0.0f;
+	m_minVelocityIterations = 1;
 	m_subStepping = false;
 
 	m_stepComplete = true;
@@ -94,11 +102,54 @@ void cb2World::SetContactFilter(cb2ContactFilter* filter)
 	m_contactManager.m_contactFilter = filter;
 }
 
+void cb2World::SetIterationPolicy(cb2IterationPolicy* policy)
+{
+	m_iterationPolicy = policy;
+}
+
 void cb2World::SetContactListener(cb2ContactListener* listener)
 {
 	m_contactManager.m_contactListener = listener;
 }
 
+void cb2World::SetBroadPhaseBackend(cb2BroadPhaseBackend* backend)
+{
+	cb2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	cb2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+
+	// Contacts only refer to fixtures, so they survive the move.
+	for (cb2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (cb2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			f->DestroyProxies(broadPhase);
+		}
+	}
+
+	broadPhase->SetBackend(backend);
+
+	for (cb2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->IsActive() == false)
+		{
+			continue;
+		}
+
+		for (cb2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			f->CreateProxies(broadPhase, b->m_xf);
+		}
+	}
+
+	// Find pairs against the new backend on the next step.
+	m_flags |= e_newFixture;
+}
+
 void cb2World::SetDebugDraw(cb2Draw* debugDraw)
 {
 	g_debugDraw = debugDraw;
@@ -137,6 +188,23 @@ void cb2World::DestroyBody(cb2Body* b)
 		return;
 	}
 
+	// Its sleeping island must not keep a pointer to it.
+	if (b->m_sleepNext)
+	{
+		b->WakeIsland();
+	}
+
+	// Give merged bodies their own fixtures back first.
+	if (b->m_compound)
+	{
+		UnmergeBody(b);
+	}
+
+	if (b->m_compoundList)
+	{
+		SplitBody(b);
+	}
+
 	// Delete the attached joints.
 	cb2JointEdge* je = b->m_jointList;
 	while (je)
@@ -209,6 +277,198 @@ void cb2World::DestroyBody(cb2Body* b)
 	m_blockAllocator.Free(b, sizeof(cb2Body));
 }
 
+// Copy a fixture onto a compound. The shape is moved into the frame of the compound,
+// given the transform from the fixture's body to the compound.
+cb2Fixture* cb2World::CopyFixture(cb2Body* compound, const cb2Fixture* fixture, const cb2Transform& xf)
+{
+	cb2CircleShape circle;
+	cb2EdgeShape edge;
+	cb2PolygonShape polygon;
+	cb2CapsuleShape capsule;
+
+	cb2FixtureDef def;
+	def.userData = fixture->GetUserData();
+	def.friction = fixture->GetFriction();
+	def.restitution = fixture->GetRestitution();
+	def.isSensor = fixture->IsSensor();
+	def.filter = fixture->GetFilterData();
+	def.breakForce = fixture->GetBreakForce();
+
+	switch (fixture->GetType())
+	{
+	case cb2Shape::e_circle:
+		circle = *(const cb2CircleShape*)fixture->GetShape();
+		circle.m_p = cb2Mul(xf, circle.m_p);
+		def.shape = &circle;
+		break;
+
+	case cb2Shape::e_edge:
+		edge = *(const cb2EdgeShape*)fixture->GetShape();
+		edge.m_vertex0 = cb2Mul(xf, edge.m_vertex0);
+		edge.m_vertex1 = cb2Mul(xf, edge.m_vertex1);
+		edge.m_vertex2 = cb2Mul(xf, edge.m_vertex2);
+		edge.m_vertex3 = cb2Mul(xf, edge.m_vertex3);
+		def.shape = &edge;
+		break;
+
+	case cb2Shape::e_polygon:
+		polygon = *(const cb2PolygonShape*)fixture->GetShape();
+		polygon.m_centroid = cb2Mul(xf, polygon.m_centroid);
+		for (int i = 0; i < polygon.m_count; ++i)
+		{
+			polygon.m_vertices[i] = cb2Mul(xf, polygon.m_vertices[i]);
+			polygon.m_normals[i] = cb2Mul(xf.q, polygon.m_normals[i]);
+		}
+		def.shape = &polygon;
+		break;
+
+	case cb2Shape::e_capsule:
+		capsule = *(const cb2CapsuleShape*)fixture->GetShape();
+		capsule.m_vertex1 = cb2Mul(xf, capsule.m_vertex1);
+		capsule.m_vertex2 = cb2Mul(xf, capsule.m_vertex2);
+		def.shape = &capsule;
+		break;
+
+	default:
+		// Chains and meshes keep acceleration structures in their own frame.
+		cb2Assert(false);
+		return NULL;
+	}
+
+	// The density is set afterwards so the mass is computed once for the whole compound.
+	cb2Fixture* copy = compound->CreateFixture(&def);
+	copy->SetDensity(fixture->GetDensity());
+	copy->m_original = (cb2Fixture*)fixture;
+	return copy;
+}
+
+cb2Body* cb2World::MergeBodies(cb2Body* const* bodies, int count)
+{
+	cb2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return NULL;
+	}
+
+	cb2Assert(count > 0);
+	cb2Body* compound = bodies[0];
+	cb2Assert(compound->m_compound == NULL && compound->IsActive());
+
+	// The joints of the other bodies become inactive, so they may only join bodies of
+	// the compound. Joints to other bodies must be made on the first body instead.
+	for (int i = 1; i < count; ++i)
+	{
+		for (cb2JointEdge* je = bodies[i]->m_jointList; je; je = je->next)
+		{
+			bool inside = false;
+			for (int k = 0; k < count; ++k)
+			{
+				inside = inside || je->other == bodies[k];
+			}
+			cb2Assert(inside);
+			CB2_NOT_USED(inside);
+		}
+	}
+
+	// Gather the momentum before the mass of the compound changes. The angular
+	// momentum is taken about the world origin.
+	ci::Vec2f linearMomentum = ci::Vec2f::zero();
+	float angularMomentum = 0.0f;
+	for (int i = 0; i < count; ++i)
+	{
+		cb2Body* b = bodies[i];
+		ci::Vec2f p = b->m_mass * b->m_linearVelocity;
+		linearMomentum += p;
+		angularMomentum += b->m_I * b->m_angularVelocity + cb2Cross(b->m_sweep.c, p);
+	}
+
+	for (int i = 1; i < count; ++i)
+	{
+		cb2Body* b = bodies[i];
+		cb2Assert(b != compound && b->IsActive());
+		cb2Assert(b->m_compound == NULL && b->m_compoundList == NULL);
+
+		cb2Transform xf = cb2MulT(compound->m_xf, b->m_xf);
+		for (cb2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			CopyFixture(compound, f, xf);
+		}
+
+		b->SetActive(false);
+		b->m_compound = compound;
+		b->m_compoundTransform = xf;
+		b->m_compoundNext = compound->m_compoundList;
+		compound->m_compoundList = b;
+	}
+
+	compound->ResetMassData();
+
+	if (compound->m_type == cb2_dynamicBody && compound->m_mass > 0.0f)
+	{
+		compound->m_linearVelocity = compound->m_invMass * linearMomentum;
+		if (compound->m_I > 0.0f)
+		{
+			angularMomentum -= cb2Cross(compound->m_sweep.c, linearMomentum);
+			compound->m_angularVelocity = compound->m_invI * angularMomentum;
+		}
+	}
+
+	compound->SetAwake(true);
+	return compound;
+}
+
+void cb2World::UnmergeBody(cb2Body* b)
+{
+	cb2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	cb2Body* compound = b->m_compound;
+	cb2Assert(compound != NULL);
+
+	// Remove the body from the compound list.
+	cb2Body** node = &compound->m_compoundList;
+	while (*node != b)
+	{
+		node = &(*node)->m_compoundNext;
+	}
+	*node = b->m_compoundNext;
+
+	// Take the rigid motion of the compound at the body's place.
+	compound->SynchronizeCompound();
+	b->m_linearVelocity = compound->m_linearVelocity + cb2Cross(compound->m_angularVelocity, b->m_sweep.c - compound->m_sweep.c);
+	b->m_angularVelocity = compound->m_angularVelocity;
+
+	b->m_compound = NULL;
+	b->m_compoundNext = NULL;
+	b->m_compoundTransform.SetIdentity();
+
+	cb2Fixture* f = compound->m_fixtureList;
+	while (f)
+	{
+		cb2Fixture* f0 = f;
+		f = f->m_next;
+
+		if (f0->m_original && f0->m_original->m_body == b)
+		{
+			compound->DestroyFixture(f0);
+		}
+	}
+
+	b->SetActive(true);
+	b->SetAwake(true);
+}
+
+void cb2World::SplitBody(cb2Body* compound)
+{
+	while (compound->m_compoundList)
+	{
+		UnmergeBody(compound->m_compoundList);
+	}
+}
+
 cb2Joint* cb2World::CreateJoint(const cb2JointDef* def)
 {
 	cb2Assert(IsLocked() == false);
@@ -217,6 +477,9 @@ cb2Joint* cb2World::CreateJoint(const cb2JointDef* def)
 		return NULL;
 	}
 
+	// Merged bodies are inactive, so their joints would have no effect.
+	cb2Assert(def->bodyA->m_compound == NULL && def->bodyB->m_compound == NULL);
+
 	cb2Joint* j = cb2Joint::Create(def, &m_blockAllocator);
 
 	// Connect to the world list.
@@ -364,6 +627,40 @@ void cb2World::DestroyJoint(cb2Joint* j)
 	}
 }
 
+int cb2World::GetJointReactions(cb2JointReaction* reactions, int capacity) const
+{
+	int count = 0;
+	for (const cb2Joint* j = m_jointList; j && count < capacity; j = j->m_next)
+	{
+		j->GetReaction(reactions + count);
+		++count;
+	}
+	return count;
+}
+
+int cb2World::GetJointImpulses(cb2JointImpulse* impulses, int capacity) const
+{
+	int count = 0;
+	for (const cb2Joint* j = m_jointList; j && count < capacity; j = j->m_next)
+	{
+		j->GetImpulses(impulses + count);
+		++count;
+	}
+	return count;
+}
+
+void cb2World::SetJointImpulses(const cb2JointImpulse* impulses, int count)
+{
+	cb2Assert(IsLocked() == false);
+
+	int i = 0;
+	for (cb2Joint* j = m_jointList; j && i < count; j = j->m_next)
+	{
+		j->SetImpulses(impulses[i]);
+		++i;
+	}
+}
+
 //
 void cb2World::SetAllowSleeping(bool flag)
 {
@@ -382,19 +679,29 @@ void cb2World::SetAllowSleeping(bool flag)
 	}
 }
 
+void cb2World::SetVelocityTolerance(float tolerance, int minIterations)
+{
+	cb2Assert(tolerance >= 0.0f && minIterations >= 1);
+	m_velocityTolerance = tolerance;
+	m_minVelocityIterations = minIterations;
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void cb2World::Solve(const cb2TimeStep& step)
 {
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
+	m_profile.velocityIterations = 0;
+	m_profile.maxVelocityIterations = 0;
 
 	// Size the island for the worst case.
 	cb2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
 					m_jointCount,
 					&m_stackAllocator,
-					m_contactManager.m_contactListener);
+					m_contactManager.m_contactListener,
+					&m_breakBuffer);
 
 	// Clear all the island flags.
 	for (cb2Body* b = m_bodyList; b; b = b->m_next)
@@ -410,6 +717,13 @@ void cb2World::Solve(const cb2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
+	SolveKinematic(step);
+
+	if (m_iterationPolicy)
+	{
+		m_iterationPolicy->BeginStep();
+	}
+
 	// Build and simulate all awake islands.
 	int stackSize = m_bodyCount;
 	cb2Body** stack = (cb2Body**)m_stackAllocator.Allocate(stackSize * sizeof(cb2Body*));
@@ -425,8 +739,8 @@ void cb2World::Solve(const cb2TimeStep& step)
 			continue;
 		}
 
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == cb2_staticBody)
+		// The seed must be dynamic. Kinematic bodies were moved by SolveKinematic.
+		if (seed->GetType() != cb2_dynamicBody)
 		{
 			continue;
 		}
@@ -445,12 +759,15 @@ void cb2World::Solve(const cb2TimeStep& step)
 			cb2Assert(b->IsActive() == true);
 			island.Add(b);
 
-			// Make sure the body is awake.
-			b->SetAwake(true);
+			// Make sure the body is awake. Kinematic bodies wake and sleep on their own.
+			if (b->GetType() != cb2_kinematicBody)
+			{
+				b->SetAwake(true);
+			}
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == cb2_staticBody)
+			// To keep islands as small as possible, we don't propagate islands
+			// across static or kinematic bodies. Both take part with infinite mass.
+			if (b->GetType() != cb2_dynamicBody)
 			{
 				continue;
 			}
@@ -505,6 +822,12 @@ void cb2World::Solve(const cb2TimeStep& step)
 					continue;
 				}
 
+				// Broken joints no longer connect their bodies.
+				if (je->joint->m_broken)
+				{
+					continue;
+				}
+
 				cb2Body* other = je->other;
 
 				// Don't simulate joints connected to inactive bodies.
@@ -527,18 +850,49 @@ void cb2World::Solve(const cb2TimeStep& step)
 			}
 		}
 
+		cb2TimeStep islandStep = step;
+		if (m_iterationPolicy || m_directSolverMassRatio > 0.0f)
+		{
+			cb2IslandInfo info;
+			info.bodyCount = island.m_bodyCount;
+			info.contactCount = island.m_contactCount;
+			info.jointCount = island.m_jointCount;
+
+			float minMass = cb2_maxFloat;
+			float maxMass = 0.0f;
+			for (int i = 0; i < island.m_bodyCount; ++i)
+			{
+				cb2Body* b = island.m_bodies[i];
+				if (b->m_type == cb2_dynamicBody)
+				{
+					minMass = cb2Min(minMass, b->m_mass);
+					maxMass = cb2Max(maxMass, b->m_mass);
+				}
+			}
+			info.massRatio = maxMass > minMass ? maxMass / minMass : 1.0f;
+
+			if (m_iterationPolicy)
+			{
+				m_iterationPolicy->ChooseIterations(info, &islandStep.velocityIterations, &islandStep.positionIterations);
+			}
+
+			islandStep.directSolver = m_directSolverMassRatio > 0.0f && info.massRatio >= m_directSolverMassRatio;
+		}
+
 		cb2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
+		island.Solve(&profile, islandStep, m_gravity, m_allowSleep);
 		m_profile.solveInit += profile.solveInit;
 		m_profile.solveVelocity += profile.solveVelocity;
 		m_profile.solvePosition += profile.solvePosition;
+		m_profile.velocityIterations += profile.velocityIterations;
+		m_profile.maxVelocityIterations = cb2Max(m_profile.maxVelocityIterations, profile.velocityIterations);
 
 		// Post solve cleanup.
 		for (int i = 0; i < island.m_bodyCount; ++i)
 		{
-			// Allow static bodies to participate in other islands.
+			// Allow static and kinematic bodies to participate in other islands.
 			cb2Body* b = island.m_bodies[i];
-			if (b->GetType() == cb2_staticBody)
+			if (b->GetType() != cb2_dynamicBody)
 			{
 				b->m_flags &= ~cb2Body::e_islandFlag;
 			}
@@ -547,18 +901,39 @@ void cb2World::Solve(const cb2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	// Let the bodies of joints that just broke collide with each other.
+	for (int i = 0; i < m_breakBuffer.m_jointBreakCount; ++i)
+	{
+		cb2Joint* j = m_breakBuffer.m_jointBreaks[i].joint;
+		if (j->m_collideConnected == false)
+		{
+			for (cb2Fixture* f = j->m_bodyB->m_fixtureList; f; f = f->m_next)
+			{
+				f->Refilter();
+			}
+		}
+	}
+
 	{
 		cb2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
 		for (cb2Body* b = m_bodyList; b; b = b->GetNext())
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & cb2Body::e_islandFlag) == 0)
+			if (b->GetType() == cb2_staticBody)
 			{
 				continue;
 			}
 
-			if (b->GetType() == cb2_staticBody)
+			// If a body was not in an island then it did not move. Awake kinematic
+			// bodies moved in SolveKinematic.
+			if (b->GetType() == cb2_kinematicBody)
+			{
+				if (b->IsAwake() == false || b->IsActive() == false)
+				{
+					continue;
+				}
+			}
+			else if ((b->m_flags & cb2Body::e_islandFlag) == 0)
 			{
 				continue;
 			}
@@ -573,10 +948,104 @@ void cb2World::Solve(const cb2TimeStep& step)
 	}
 }
 
+// Move the kinematic bodies once for the whole step. Islands treat them like static
+// bodies with a known velocity and start them from the sweep positions stored here,
+// so islands do not merge through them. A moving kinematic body wakes the bodies it
+// touches so that they form islands of their own.
+void cb2World::SolveKinematic(const cb2TimeStep& step)
+{
+	float h = step.dt;
+
+	const float linTolSqr = cb2_linearSleepTolerance * cb2_linearSleepTolerance;
+	const float angTolSqr = cb2_angularSleepTolerance * cb2_angularSleepTolerance;
+
+	for (cb2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->m_type != cb2_kinematicBody || b->IsActive() == false)
+		{
+			continue;
+		}
+
+		// Store positions for continuous collision.
+		b->m_sweep.c0 = b->m_sweep.c;
+		b->m_sweep.a0 = b->m_sweep.a;
+
+		if (b->IsAwake() == false)
+		{
+			continue;
+		}
+
+		ci::Vec2f v = b->m_linearVelocity;
+		float w = b->m_angularVelocity;
+
+		if (m_allowSleep)
+		{
+			if ((b->m_flags & cb2Body::e_autoSleepFlag) == 0 ||
+				w * w > angTolSqr ||
+				cb2Dot(v, v) > linTolSqr)
+			{
+				b->m_sleepTime = 0.0f;
+			}
+			else
+			{
+				b->m_sleepTime += h;
+			}
+
+			if (b->m_sleepTime >= cb2_timeToSleep)
+			{
+				b->SetAwake(false);
+				continue;
+			}
+		}
+
+		if (v.x == 0.0f && v.y == 0.0f && w == 0.0f)
+		{
+			continue;
+		}
+
+		for (cb2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			cb2Contact* contact = ce->contact;
+			if (contact->IsEnabled() && contact->IsTouching() &&
+				contact->m_fixtureA->m_isSensor == false && contact->m_fixtureB->m_isSensor == false)
+			{
+				ce->other->SetAwake(true);
+			}
+		}
+
+		for (cb2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_broken == false)
+			{
+				je->other->SetAwake(true);
+			}
+		}
+
+		// Check for large velocities
+		ci::Vec2f translation = h * v;
+		if (cb2Dot(translation, translation) > cb2_maxTranslationSquared)
+		{
+			v *= cb2_maxTranslation / translation.length();
+		}
+
+		float rotation = h * w;
+		if (rotation * rotation > cb2_maxRotationSquared)
+		{
+			w *= cb2_maxRotation / cb2Abs(rotation);
+		}
+
+		b->m_sweep.c += h * v;
+		b->m_sweep.a += h * w;
+		b->m_linearVelocity = v;
+		b->m_angularVelocity = w;
+		b->SynchronizeTransform();
+	}
+}
+
 // Find TOI contacts and solve them.
 void cb2World::SolveTOI(const cb2TimeStep& step)
 {
-	cb2Island island(2 * cb2_maxTOIContacts, cb2_maxTOIContacts, 0, &m_stackAllocator, m_contactManager.m_contactListener);
+	cb2Island island(2 * cb2_maxTOIContacts, cb2_maxTOIContacts, 0, &m_stackAllocator, m_contactManager.m_contactListener, NULL);
 
 	if (m_stepComplete)
 	{
@@ -604,8 +1073,8 @@ void cb2World::SolveTOI(const cb2TimeStep& step)
 
 		for (cb2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
 		{
-			// Is this contact disabled?
-			if (c->IsEnabled() == false)
+			// Is this contact disabled or asleep?
+			if (c->IsEnabled() == false || (c->m_flags & cb2Contact::e_sleepFlag))
 			{
 				continue;
 			}
@@ -687,7 +1156,7 @@ void cb2World::SolveTOI(const cb2TimeStep& step)
 				input.tMax = 1.0f;
 
 				cb2TOIOutput output;
-				cb2TimeOfImpact(&output, &input);
+				cb2TimeOfImpact(&output, &input, &c->m_simplexCache);
 
 				// Beta is the fraction of the remaining portion of the .
 				float beta = output.t;
@@ -859,7 +1328,12 @@ void cb2World::SolveTOI(const cb2TimeStep& step)
 		subStep.dtRatio = 1.0f;
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
+		subStep.velocityTolerance = 0.0f;
+		subStep.minVelocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		subStep.speculative = false;
+		subStep.softSubSteps = 0;
+		subStep.directSolver = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -898,6 +1372,8 @@ void cb2World::Step(float dt, int velocityIterations, int positionIterations)
 {
 	cb2Timer stepTimer;
 
+	m_breakBuffer.Clear();
+
 	// If new fixtures were added, we need to find the new contacts.
 	if (m_flags & e_newFixture)
 	{
@@ -911,6 +1387,9 @@ void cb2World::Step(float dt, int velocityIterations, int positionIterations)
 	step.dt = dt;
 	step.velocityIterations	= velocityIterations;
 	step.positionIterations = positionIterations;
+	step.velocityTolerance = m_velocityTolerance;
+	step.minVelocityIterations = m_minVelocityIterations;
+	step.directSolver = false;
 	if (dt > 0.0f)
 	{
 		step.inv_dt = 1.0f / dt;
@@ -920,12 +1399,17 @@ void cb2World::Step(float dt, int velocityIterations, int positionIterations)
 		step.inv_dt = 0.0f;
 	}
 
-	step.dtRatio = m_inv_dt0 * dt;
+	// Nothing has been stepped yet on the first step, so keep any impulses that
+	// were restored into the world instead of scaling them to zero.
+	step.dtRatio = m_inv_dt0 > 0.0f ? m_inv_dt0 * dt : 1.0f;
 
 	step.warmStarting = m_warmStarting;
+	step.speculative = m_speculativeContacts;
+	step.softSubSteps = m_softSubSteps;
 	
 	// Update contacts. This is where some contacts are destroyed.
 	{
+		m_contactManager.m_speculativeTime = m_speculativeContacts ? dt : 0.0f;
 		cb2Timer timer;
 		m_contactManager.Collide();
 		m_profile.collide = timer.GetMilliseconds();
@@ -939,14 +1423,17 @@ void cb2World::Step(float dt, int velocityIterations, int positionIterations)
 		m_profile.solve = timer.GetMilliseconds();
 	}
 
-	// Handle TOI events.
-	if (m_continuousPhysics && step.dt > 0.0f)
+	// Handle TOI events. Speculative contacts take their place.
+	if (m_continuousPhysics && m_speculativeContacts == false && step.dt > 0.0f)
 	{
 		cb2Timer timer;
 		SolveTOI(step);
 		m_profile.solveTOI = timer.GetMilliseconds();
 	}
 
+	// Let the broad-phase restore its quality now that the proxies have settled.
+	m_contactManager.m_broadPhase.Maintain();
+
 	if (step.dt > 0.0f)
 	{
 		m_inv_dt0 = step.inv_dt;
@@ -1085,6 +1572,49 @@ void cb2World::DrawShape(cb2Fixture* fixture, const cb2Transform& xf, const cb2C
 			g_debugDraw->DrawSolidPolygon(vertices, vertexCount, color);
 		}
 		break;
+
+	case cb2Shape::e_capsule:
+		{
+			cb2CapsuleShape* capsule = (cb2CapsuleShape*)fixture->GetShape();
+			ci::Vec2f v1 = cb2Mul(xf, capsule->m_vertex1);
+			ci::Vec2f v2 = cb2Mul(xf, capsule->m_vertex2);
+			float radius = capsule->m_radius;
+
+			ci::Vec2f axis = v2 - v1;
+			axis.normalize();
+			ci::Vec2f offset = radius * cb2Cross(axis, 1.0f);
+
+			g_debugDraw->DrawSolidCircle(v1, radius, -axis, color);
+			g_debugDraw->DrawSolidCircle(v2, radius, axis, color);
+			g_debugDraw->DrawSegment(v1 + offset, v2 + offset, color);
+			g_debugDraw->DrawSegment(v1 - offset, v2 - offset, color);
+		}
+		break;
+
+	case cb2Shape::e_mesh:
+		{
+			cb2MeshShape* mesh = (cb2MeshShape*)fixture->GetShape();
+			int pieceSize = mesh->m_pieceSize;
+			for (int i = 0; i < mesh->m_pieceCount; ++i)
+			{
+				const int* piece = mesh->m_indices + pieceSize * i;
+				ci::Vec2f vertices[3];
+				for (int j = 0; j < pieceSize; ++j)
+				{
+					vertices[j] = cb2Mul(xf, mesh->m_vertices[piece[j]]);
+				}
+
+				if (pieceSize == 2)
+				{
+					g_debugDraw->DrawSegment(vertices[0], vertices[1], color);
+				}
+				else
+				{
+					g_debugDraw->DrawPolygon(vertices, pieceSize, color);
+				}
+			}
+		}
+		break;
             
     default:
         break;
@@ -1176,7 +1706,10 @@ void cb2World::DrawDebugData()
 	{
 		for (cb2Joint* j = m_jointList; j; j = j->GetNext())
 		{
-			DrawJoint(j);
+			if (j->IsBroken() == false)
+			{
+				DrawJoint(j);
+			}
 		}
 	}
 
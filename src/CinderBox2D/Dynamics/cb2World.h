@@ -23,6 +23,7 @@
 #include <CinderBox2D/Common/cb2BlockAllocator.h>
 #include <CinderBox2D/Common/cb2StackAllocator.h>
 #include <CinderBox2D/Dynamics/cb2ContactManager.h>
+#include <CinderBox2D/Dynamics/cb2BreakBuffer.h>
 #include <CinderBox2D/Dynamics/cb2WorldCallbacks.h>
 #include <CinderBox2D/Dynamics/cb2TimeStep.h>
 
@@ -30,6 +31,8 @@ struct cb2AABB;
 struct cb2BodyDef;
 struct cb2Color;
 struct cb2JointDef;
+struct cb2JointImpulse;
+struct cb2JointReaction;
 class cb2Body;
 class cb2Draw;
 class cb2Fixture;
@@ -61,6 +64,17 @@ public:
 	/// remain in scope.
 	void SetContactListener(cb2ContactListener* listener);
 
+	/// Register a policy that chooses the iterations of each island, such as a
+	/// cb2IterationBudget. Pass NULL to give every island the counts passed to Step.
+	/// The policy is owned by you and must remain in scope.
+	void SetIterationPolicy(cb2IterationPolicy* policy);
+
+	/// Replace the broad-phase backend, for example with a cb2SweepAndPruneBroadPhase.
+	/// Existing proxies are moved to the new backend. Pass NULL to restore the
+	/// default dynamic tree. The backend is owned by you and must remain in scope.
+	/// @warning This function is locked during callbacks.
+	void SetBroadPhaseBackend(cb2BroadPhaseBackend* backend);
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with cb2World::DrawDebugData method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -77,6 +91,28 @@ public:
 	/// @warning This function is locked during callbacks.
 	void DestroyBody(cb2Body* body);
 
+	/// Merge bodies into one compound body, so that a welded cluster is solved as a
+	/// single rigid body. The fixtures of the other bodies are copied onto the first
+	/// body, which becomes the compound, and its mass is recomputed once. The other
+	/// bodies are deactivated and follow the compound until they are split off, so
+	/// their joints are inactive meanwhile. Those joints may only join bodies of the
+	/// merge. Joints to other bodies must be attached to the first body. Momentum is
+	/// conserved. Chain and mesh fixtures cannot be merged. Destroying a compound
+	/// splits it first.
+	/// @warning This function is locked during callbacks.
+	/// @return the compound, which is bodies[0].
+	cb2Body* MergeBodies(cb2Body* const* bodies, int count);
+
+	/// Split a merged body off its compound, for example the body of a fixture copy
+	/// reported by a contact break. It gets the velocity of the compound at its place.
+	/// @see cb2Fixture::GetOriginal
+	/// @warning This function is locked during callbacks.
+	void UnmergeBody(cb2Body* body);
+
+	/// Split all merged bodies off a compound.
+	/// @warning This function is locked during callbacks.
+	void SplitBody(cb2Body* compound);
+
 	/// Create a joint to constrain bodies together. No reference to the definition
 	/// is retained. This may cause the connected bodies to cease colliding.
 	/// @warning This function is locked during callbacks.
@@ -133,6 +169,33 @@ public:
 	cb2Joint* GetJointList();
 	const cb2Joint* GetJointList() const;
 
+	/// Read the reaction impulses of all joints from the last step into a flat array,
+	/// in joint list order. Use this to test break thresholds over many joints at once.
+	/// @return the number of reactions written, at most capacity.
+	int GetJointReactions(cb2JointReaction* reactions, int capacity) const;
+
+	/// Save the accumulated impulses of all joints, in joint list order.
+	/// @return the number of joints written, at most capacity.
+	int GetJointImpulses(cb2JointImpulse* impulses, int capacity) const;
+
+	/// Restore impulses saved with GetJointImpulses, in joint list order. A world rebuilt
+	/// by creating its joints in the same order gets each joint's own impulses back.
+	void SetJointImpulses(const cb2JointImpulse* impulses, int count);
+
+	/// Get the joints that broke during the last time step. A joint breaks when its
+	/// reaction exceeds the break force or torque of its definition.
+	/// @see cb2JointDef::breakForce
+	const cb2JointBreak* GetJointBreaks() const;
+	int GetJointBreakCount() const;
+
+	/// Get the contacts whose normal force exceeded their break force during the
+	/// last time step. Use this to split bodies at the impact point. A contact is
+	/// reported once: its break force is then set to cb2_maxFloat until you call
+	/// cb2Contact::SetBreakForce or cb2Contact::ResetBreakForce.
+	/// @see cb2FixtureDef::breakForce
+	const cb2ContactBreak* GetContactBreaks() const;
+	int GetContactBreakCount() const;
+
 	/// Get the world contact list. With the returned contact, use cb2Contact::GetNext to get
 	/// the next contact in the world list. A NULL contact indicates the end of the list.
 	/// @return the head of the world contact list.
@@ -153,10 +216,57 @@ public:
 	void SetContinuousPhysics(bool flag) { m_continuousPhysics = flag; }
 	bool GetContinuousPhysics() const { return m_continuousPhysics; }
 
+	/// Enable/disable speculative contacts. Contacts then get points for shapes that are
+	/// apart by less than the distance their bodies may close in during the step, and the
+	/// solver lets such points approach by no more than their gap. This replaces the TOI
+	/// sub-stepping of continuous physics at a cost that does not grow with the number of
+	/// fast bodies. Contacts with speculative points count as touching before the shapes
+	/// meet. Off by default.
+	void SetSpeculativeContacts(bool flag) { m_speculativeContacts = flag; }
+	bool GetSpeculativeContacts() const { return m_speculativeContacts; }
+
+	/// Select the soft step solver with this many sub-steps per step. Each sub-step runs
+	/// one velocity pass with contacts treated as stiff damped springs, integrates the
+	/// positions and runs one relaxing velocity pass. This keeps tall stacks and heavy
+	/// ragdolls stable at a fraction of the iterations the classic solver needs. The
+	/// iteration counts passed to Step are then ignored. Contact and joint impulses are
+	/// reported for the whole step, as with the classic solver. Zero, the default, selects
+	/// the classic solver. Four sub-steps suit most scenes.
+	void SetSoftSubSteps(int count) { cb2Assert(count >= 0); m_softSubSteps = count; }
+	int GetSoftSubSteps() const { return m_softSubSteps; }
+
+	/// Let the velocity solver of an island stop before the iteration count passed to Step
+	/// once a pass changes no constraint velocity by more than the tolerance in meters per
+	/// second. At least minIterations passes run. A tolerance of zero, the default, runs
+	/// every pass. A tenth of cb2_linearSleepTolerance keeps settling and sleep close to
+	/// running every pass. The passes taken are reported in the profile.
+	void SetVelocityTolerance(float tolerance, int minIterations = 1);
+	float GetVelocityTolerance() const { return m_velocityTolerance; }
+
+	/// Solve the contact normal impulses of small islands together, as one exact
+	/// LCP, once the ratio of the largest to the smallest body mass in the island
+	/// reaches massRatio. Heavy bodies on light ones then rest firmly without extra
+	/// iterations. Friction and joints are still solved iteratively. Islands with more
+	/// than cb2_maxDirectContactPoints points and the soft step solver are not affected.
+	/// Zero, the default, turns the direct solver off.
+	void SetDirectSolverMassRatio(float massRatio) { cb2Assert(massRatio >= 0.0f); m_directSolverMassRatio = massRatio; }
+	float GetDirectSolverMassRatio() const { return m_directSolverMassRatio; }
+
 	/// Enable/disable single stepped continuous physics. For testing.
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Enable/disable manifold reuse. A contact whose bodies moved less than the reuse
+	/// tolerances relative to each other since its last evaluation skips the narrow-phase
+	/// and keeps its manifold, including the impulses used for warm starting.
+	/// Off by default.
+	void SetManifoldReuse(bool flag) { m_contactManager.m_reuseManifolds = flag; }
+	bool GetManifoldReuse() const { return m_contactManager.m_reuseManifolds; }
+
+	/// Set the relative motion below which manifolds are reused. The linear tolerance
+	/// is in meters and the angular tolerance in radians.
+	void SetManifoldReuseTolerance(float linear, float angular);
+
 	/// Get the number of broad-phase proxies.
 	int GetProxyCount() const;
 
@@ -205,7 +315,7 @@ public:
 	/// Get the current profile.
 	const cb2Profile& GetProfile() const;
 
-	/// Dump the world into the log file.
+	/// Dump the world into the log file. Compound bodies are dumped unmerged.
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
@@ -225,8 +335,11 @@ private:
 	friend class cb2Controller;
 
 	void Solve(const cb2TimeStep& step);
+	void SolveKinematic(const cb2TimeStep& step);
 	void SolveTOI(const cb2TimeStep& step);
 
+	cb2Fixture* CopyFixture(cb2Body* compound, const cb2Fixture* fixture, const cb2Transform& xf);
+
 	void DrawJoint(cb2Joint* joint);
 	void DrawShape(cb2Fixture* shape, const cb2Transform& xf, const cb2Color& color);
 
@@ -236,6 +349,7 @@ private:
 	int m_flags;
 
 	cb2ContactManager m_contactManager;
+	cb2BreakBuffer m_breakBuffer;
 
 	cb2Body* m_bodyList;
 	cb2Joint* m_jointList;
@@ -247,6 +361,7 @@ private:
 	bool m_allowSleep;
 
 	cb2DestructionListener* m_destructionListener;
+	cb2IterationPolicy* m_iterationPolicy;
 	cb2Draw* g_debugDraw;
 
 	// This is used to compute the time step ratio to
@@ -256,7 +371,12 @@ private:
 	// These are for debugging the solver.
 	bool m_warmStarting;
 	bool m_continuousPhysics;
+	bool m_speculativeContacts;
 	bool m_subStepping;
+	int m_softSubSteps;
+	float m_velocityTolerance;
+	int m_minVelocityIterations;
+	float m_directSolverMassRatio;
 
 	bool m_stepComplete;
 
@@ -323,6 +443,13 @@ inline bool cb2World::IsLocked() const
 	return (m_flags & e_locked) == e_locked;
 }
 
+inline void cb2World::SetManifoldReuseTolerance(float linear, float angular)
+{
+	cb2Assert(linear >= 0.0f && angular >= 0.0f);
+	m_contactManager.m_reuseLinearTolerance = linear;
+	m_contactManager.m_reuseAngularTolerance = angular;
+}
+
 inline void cb2World::SetAutoClearForces(bool flag)
 {
 	if (flag)
@@ -351,4 +478,24 @@ inline const cb2Profile& cb2World::GetProfile() const
 	return m_profile;
 }
 
+inline const cb2JointBreak* cb2World::GetJointBreaks() const
+{
+	return m_breakBuffer.m_jointBreaks;
+}
+
+inline int cb2World::GetJointBreakCount() const
+{
+	return m_breakBuffer.m_jointBreakCount;
+}
+
+inline const cb2ContactBreak* cb2World::GetContactBreaks() const
+{
+	return m_breakBuffer.m_contactBreaks;
+}
+
+inline int cb2World::GetContactBreakCount() const
+{
+	return m_breakBuffer.m_contactBreakCount;
+}
+
 #endif
@@ -34,3 +34,60 @@ bool cb2ContactFilter::ShouldCollide(cb2Fixture* fixtureA, cb2Fixture* fixtureB)
 	bool collide = (filterA.maskBits & filterB.categoryBits) != 0 && (filterA.categoryBits & filterB.maskBits) != 0;
 	return collide;
 }
+
+cb2IterationBudget::cb2IterationBudget(int budget, int minIterations, int maxIterations)
+{
+	cb2Assert(budget >= 0);
+	cb2Assert(1 <= minIterations && minIterations <= maxIterations);
+	m_budget = budget;
+	m_minIterations = minIterations;
+	m_maxIterations = maxIterations;
+	m_remainingBudget = 0;
+	m_scale = 1.0f;
+	m_demand = 0.0f;
+}
+
+void cb2IterationBudget::BeginStep()
+{
+	// Islands are visited in body order, so scale by the demand of the last step
+	// rather than favor the islands solved first.
+	m_scale = 1.0f;
+	if (m_budget > 0 && m_demand > (float)m_budget)
+	{
+		m_scale = (float)m_budget / m_demand;
+	}
+
+	m_demand = 0.0f;
+	m_remainingBudget = m_budget;
+}
+
+void cb2IterationBudget::ChooseIterations(const cb2IslandInfo& island, int* velocityIterations, int* positionIterations)
+{
+	CB2_NOT_USED(positionIterations);
+
+	int constraintCount = island.contactCount + island.jointCount;
+
+	// Gauss-Seidel carries an impulse about one constraint further per pass, so small
+	// islands converge in about as many passes as they have constraints.
+	float iterations = (float)cb2Min(*velocityIterations, m_minIterations + constraintCount - 1);
+
+	// Heavy bodies on light ones and long joint chains converge slowly.
+	if (constraintCount > 1)
+	{
+		iterations *= 1.0f + 0.25f * logf(island.massRatio) / logf(2.0f);
+		iterations *= 1.0f + 0.5f * island.jointCount / constraintCount;
+	}
+
+	iterations = cb2Min(iterations, (float)m_maxIterations);
+	m_demand += iterations * constraintCount;
+
+	int count = cb2Clamp((int)(m_scale * iterations + 0.5f), m_minIterations, m_maxIterations);
+
+	if (m_budget > 0 && constraintCount > 0)
+	{
+		count = cb2Max(cb2Min(count, m_remainingBudget / constraintCount), m_minIterations);
+		m_remainingBudget = cb2Max(m_remainingBudget - count * constraintCount, 0);
+	}
+
+	*velocityIterations = count;
+}
@@ -68,6 +68,28 @@ struct cb2ContactImpulse
 	int count;
 };
 
+/// A joint that broke because its reaction exceeded the break force or torque of
+/// its definition. The joint stays in the world, but no longer constrains its bodies.
+/// @see cb2World::GetJointBreaks
+struct cb2JointBreak
+{
+	cb2Joint* joint;			///< the broken joint
+	ci::Vec2f force;			///< the reaction force on bodyB in Newtons
+	float torque;				///< the reaction torque on bodyB in N*m
+};
+
+/// A contact whose normal force exceeded the break force of its fixtures.
+/// @see cb2World::GetContactBreaks
+struct cb2ContactBreak
+{
+	cb2Contact* contact;		///< the contact, valid until the next time step
+	cb2Fixture* fixtureA;		///< the first fixture of the contact
+	cb2Fixture* fixtureB;		///< the second fixture of the contact
+	ci::Vec2f point;			///< the impulse weighted contact point in world coordinates
+	ci::Vec2f normal;			///< the world normal pointing from A to B
+	float normalForce;			///< the total normal force in Newtons
+};
+
 /// Implement this class to get contact information. You can use these results for
 /// things like sounds and game logic. You can also get contact results by
 /// traversing the contact lists after the time step. However, you might miss
@@ -117,6 +139,66 @@ public:
 	}
 };
 
+/// Describes an island that is about to be solved.
+/// @see cb2IterationPolicy
+struct cb2IslandInfo
+{
+	int bodyCount;
+	int contactCount;
+	int jointCount;
+
+	/// The largest over the smallest mass of the dynamic bodies, at least one.
+	float massRatio;
+};
+
+/// Implement this class to choose the iterations of each island. Islands are solved
+/// one after another, so a policy can spread a budget over the step.
+/// The soft step solver does not use iteration counts.
+class cb2IterationPolicy
+{
+public:
+	virtual ~cb2IterationPolicy() {}
+
+	/// Called before the islands of a step are solved.
+	virtual void BeginStep() {}
+
+	/// Choose the iterations of an island. The counts hold the values passed to
+	/// cb2World::Step on entry.
+	virtual void ChooseIterations(const cb2IslandInfo& island, int* velocityIterations, int* positionIterations) = 0;
+};
+
+/// The built-in iteration policy. An island gets velocity iterations by how hard it is
+/// to solve. A single constraint needs few. Larger islands need up to the step's count.
+/// Mass ratios and joints ask for more. The velocity iterations times the constraints,
+/// summed over the islands of a step, are kept within a budget. When the islands of the
+/// last step asked for more than the budget, all requests are scaled down alike, and no
+/// island may take more than is left. Only the minimum iterations may exceed the budget.
+/// Position iterations are left alone since the position solver stops early.
+class cb2IterationBudget : public cb2IterationPolicy
+{
+public:
+	/// @param budget the most constraint iterations per step, zero for no budget.
+	/// @param minIterations the fewest velocity iterations of an island.
+	/// @param maxIterations the most velocity iterations of an island.
+	cb2IterationBudget(int budget = 0, int minIterations = 2, int maxIterations = 30);
+
+	void BeginStep();
+	void ChooseIterations(const cb2IslandInfo& island, int* velocityIterations, int* positionIterations);
+
+	/// Change the budget. It applies from the next step.
+	void SetBudget(int budget) { m_budget = budget; }
+	int GetBudget() const { return m_budget; }
+
+private:
+	int m_budget;
+	int m_minIterations;
+	int m_maxIterations;
+
+	int m_remainingBudget;
+	float m_scale;
+	float m_demand;
+};
+
 /// Callback class for AABB queries.
 /// See cb2World::Query
 class cb2QueryCallback